@@ -0,0 +1,47 @@
+#ifndef TK_ALIGNED_ALLOCATOR_H
+#define TK_ALIGNED_ALLOCATOR_H
+
+#include "types.h"
+#include <cstddef>
+#include <new>
+#include <vector>
+
+namespace tk
+{
+
+template <typename T, size_t Alignment> class AlignedAllocator
+{
+public:
+  using value_type = T;
+
+  template <typename U> struct rebind
+  {
+    using other = AlignedAllocator<U, Alignment>;
+  };
+
+  AlignedAllocator() = default;
+  template <typename U> AlignedAllocator(const AlignedAllocator<U, Alignment>&)
+  {
+  }
+
+  T* allocate(size_t count)
+  {
+    return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t(Alignment)));
+  }
+
+  void deallocate(T* data, size_t)
+  {
+    ::operator delete(data, std::align_val_t(Alignment));
+  }
+
+  template <typename U> bool operator==(const AlignedAllocator<U, Alignment>&) const
+  {
+    return true;
+  }
+};
+
+template <typename T, size_t Alignment> using AlignedArray = std::vector<T, AlignedAllocator<T, Alignment>>;
+
+} // namespace tk
+
+#endif // !TK_ALIGNED_ALLOCATOR_H
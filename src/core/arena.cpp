@@ -0,0 +1,70 @@
+#include "arena.h"
+#include <cstdint>
+#include <new>
+
+namespace tk
+{
+
+Arena::Arena(size_t blockSize) : mBlockSize(blockSize)
+{
+}
+
+Arena::~Arena()
+{
+  Release();
+}
+
+void* Arena::Allocate(size_t size, size_t alignment)
+{
+  while (mBlock < mBlocks.size())
+  {
+    Block& block = mBlocks[mBlock];
+    uintptr_t base = (uintptr_t)block.Data;
+    size_t offset = ((base + mOffset + alignment - 1) & ~(uintptr_t)(alignment - 1)) - base;
+    if (offset + size <= block.Size)
+    {
+      mOffset = offset + size;
+      mUsed += size;
+      return block.Data + offset;
+    }
+    mBlock++;
+    mOffset = 0;
+  }
+
+  // Oversized allocations get a block of their own.
+  size_t blockSize = size + alignment > mBlockSize ? size + alignment : mBlockSize;
+  u8* data = static_cast<u8*>(::operator new(blockSize, std::align_val_t(alignof(std::max_align_t))));
+  mBlocks.push_back({data, blockSize});
+  mBlock = (u32)mBlocks.size() - 1;
+  mOffset = 0;
+  return Allocate(size, alignment);
+}
+
+void Arena::Reset()
+{
+  mBlock = 0;
+  mOffset = 0;
+  mUsed = 0;
+}
+
+void Arena::Release()
+{
+  for (Block& block : mBlocks)
+  {
+    ::operator delete(block.Data, std::align_val_t(alignof(std::max_align_t)));
+  }
+  mBlocks.clear();
+  Reset();
+}
+
+size_t Arena::GetReserved() const
+{
+  size_t bytes = 0;
+  for (const Block& block : mBlocks)
+  {
+    bytes += block.Size;
+  }
+  return bytes;
+}
+
+} // namespace tk
@@ -0,0 +1,62 @@
+#ifndef TK_ARENA_H
+#define TK_ARENA_H
+
+#include "core/dynamic_array.h"
+#include "types.h"
+#include <cstddef>
+
+namespace tk
+{
+
+// Bump allocator over large blocks. Allocations are never freed one by one,
+// Reset hands all of them back at once and keeps the blocks for reuse. Not
+// thread-safe, use one arena per thread.
+class Arena
+{
+public:
+  static constexpr size_t DefaultBlockSize = 64 * 1024;
+
+private:
+  struct Block
+  {
+    u8* Data = nullptr;
+    size_t Size = 0;
+  };
+
+  DynamicArray<Block> mBlocks = {};
+  size_t mBlockSize = DefaultBlockSize;
+  u32 mBlock = 0;
+  size_t mOffset = 0;
+  size_t mUsed = 0;
+
+public:
+  explicit Arena(size_t blockSize = DefaultBlockSize);
+  ~Arena();
+
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+
+  void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+  template <typename T> T* Allocate(size_t count = 1)
+  {
+    return static_cast<T*>(Allocate(count * sizeof(T), alignof(T)));
+  }
+
+  // Forgets every allocation, the memory is reused by the next ones.
+  void Reset();
+  // Reset and give the blocks back to the system.
+  void Release();
+
+  // Bytes handed out since the last Reset.
+  size_t GetUsed() const
+  {
+    return mUsed;
+  }
+
+  size_t GetReserved() const;
+};
+
+} // namespace tk
+
+#endif // !TK_ARENA_H
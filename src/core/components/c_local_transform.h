@@ -0,0 +1,20 @@
+#ifndef TK_C_LOCAL_TRANSFORM
+#define TK_C_LOCAL_TRANSFORM
+
+#include "core/types.h"
+
+namespace tk
+{
+
+// Transform relative to the entity's CParent. Changes must go through
+// registry.patch/replace to reach the hierarchy.
+struct CLocalTransform
+{
+  v2 Position = v2(0.f);
+  f32 Rotation = 0.f;
+  f32 Scale = 1.f;
+};
+
+} // namespace tk
+
+#endif // !TK_C_LOCAL_TRANSFORM
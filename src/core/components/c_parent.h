@@ -0,0 +1,18 @@
+#ifndef TK_C_PARENT
+#define TK_C_PARENT
+
+#include "core/ecs/registry.h"
+
+namespace tk
+{
+
+// Attaches the entity to a parent. Its CTransform then follows the parent's,
+// offset by its CLocalTransform.
+struct CParent
+{
+  entt::entity Parent = entt::null;
+};
+
+} // namespace tk
+
+#endif // !TK_C_PARENT
@@ -0,0 +1,20 @@
+#ifndef TK_C_PREV_TRANSFORM
+#define TK_C_PREV_TRANSFORM
+
+#include "core/components/c_transform2d.h"
+
+namespace tk
+{
+
+// CTransform as of the previous simulation step, rendering interpolates
+// between the two. Kept in sync with CTransform by SPrevTransform.
+struct CPrevTransform
+{
+  v2 Position = v2(0.f);
+  f32 Rotation = 0.f;
+  f32 Scale = 0.f;
+};
+
+} // namespace tk
+
+#endif // !TK_C_PREV_TRANSFORM
@@ -0,0 +1,17 @@
+#ifndef TK_C_VELOCITY
+#define TK_C_VELOCITY
+
+#include "core/types.h"
+
+namespace tk
+{
+
+struct CVelocity
+{
+  v2 Linear = v2(0.f);
+  f32 Angular = 0.f;
+};
+
+} // namespace tk
+
+#endif // !TK_C_VELOCITY
@@ -0,0 +1,43 @@
+#include "change_tracker.h"
+
+namespace tk
+{
+
+void ChangeTracker::MarkChanged(entt::entity entity)
+{
+  u32 slot = entt::to_entity(entity);
+  if (slot >= mMarks.size())
+  {
+    mMarks.resize(slot + 1);
+  }
+
+  Mark& mark = mMarks[slot];
+  if (mark.Entity == entity && mark.Tick == mTick)
+  {
+    return;
+  }
+  mark = {entity, mTick};
+  mChanged[mTick % HistoryTicks].push_back(entity);
+}
+
+void ChangeTracker::MarkChanged(const entt::entity* entities, u32 count)
+{
+  for (u32 i = 0; i < count; i++)
+  {
+    MarkChanged(entities[i]);
+  }
+}
+
+void ChangeTracker::MarkAllChanged()
+{
+  mValidSince = mTick + 1;
+}
+
+u32 ChangeTracker::Advance()
+{
+  u32 closed = mTick++;
+  mChanged[mTick % HistoryTicks].clear();
+  return closed;
+}
+
+} // namespace tk
@@ -0,0 +1,146 @@
+#ifndef TK_CHANGE_TRACKER_H
+#define TK_CHANGE_TRACKER_H
+
+#include "core/dynamic_array.h"
+#include "core/ecs/registry.h"
+
+namespace tk
+{
+
+// Records which entities had a component changed, bucketed by tick. Consumers
+// remember the tick they last caught up to and only visit what changed since,
+// instead of rescanning every entity.
+//
+// Not thread-safe. Registry hooks mark emplace/patch/replace, code that writes
+// components in place, like parallel systems, marks after its parallel pass.
+class ChangeTracker
+{
+public:
+  // Last tick of a consumer that never caught up, it has to process everything.
+  static constexpr u32 NeverTick = 0;
+  // Ticks kept around. Every consumer catching up starts a new tick, one that
+  // falls further behind than this gets a full pass instead.
+  static constexpr u32 HistoryTicks = 64;
+
+private:
+  struct Mark
+  {
+    entt::entity Entity = entt::null;
+    u32 Tick = NeverTick;
+  };
+
+  // Latest mark per entity slot, so an entity is listed once per tick and
+  // older listings of it are skipped.
+  DynamicArray<Mark> mMarks = {};
+  DynamicArray<entt::entity> mChanged[HistoryTicks] = {};
+  u32 mTick = NeverTick + 1;
+  // Consumers that caught up before this tick must do a full pass.
+  u32 mValidSince = NeverTick + 1;
+
+public:
+  void MarkChanged(entt::entity entity);
+  void MarkChanged(const entt::entity* entities, u32 count);
+  // Everything changed, e.g. after a bulk rewrite. Consumers do a full pass.
+  void MarkAllChanged();
+
+  u32 GetTick() const
+  {
+    return mTick;
+  }
+
+  // Closes the current tick and returns it. Changes from now on land in the
+  // next one.
+  u32 Advance();
+
+  // Whether the changes after lastTick are still known.
+  bool IsValid(u32 lastTick) const
+  {
+    return lastTick != NeverTick && lastTick + 1 >= mValidSince && mTick - lastTick <= HistoryTicks;
+  }
+
+  // Calls func(entity) once per entity changed after lastTick, without
+  // advancing. Entities may have been destroyed or lost the component since.
+  // Returns false without visiting anything if the history is gone.
+  template <typename Func> bool ForEachChangedSince(u32 lastTick, Func&& func) const
+  {
+    if (!IsValid(lastTick))
+    {
+      return false;
+    }
+
+    for (u32 tick = lastTick + 1; tick <= mTick; tick++)
+    {
+      for (entt::entity entity : mChanged[tick % HistoryTicks])
+      {
+        const Mark& mark = mMarks[entt::to_entity(entity)];
+        if (mark.Entity == entity && mark.Tick == tick)
+        {
+          func(entity);
+        }
+      }
+    }
+    return true;
+  }
+
+  // ForEachChangedSince followed by Advance, for consumers with a single
+  // cursor. lastTick is moved up either way.
+  template <typename Func> bool Consume(u32& lastTick, Func&& func)
+  {
+    bool bValid = ForEachChangedSince(lastTick, func);
+    lastTick = Advance();
+    return bValid;
+  }
+};
+
+// One tracker per component type, stored in the registry context and fed by
+// the component's construct and update signals.
+template <typename C> class ComponentChanges : public ChangeTracker
+{
+public:
+  static void Connect(Registry& registry)
+  {
+    ComponentChanges& changes = registry.ctx().emplace<ComponentChanges>();
+    registry.on_construct<C>().template connect<&ComponentChanges::OnChange>(changes);
+    registry.on_update<C>().template connect<&ComponentChanges::OnChange>(changes);
+  }
+
+  static void Disconnect(Registry& registry)
+  {
+    ComponentChanges& changes = registry.ctx().get<ComponentChanges>();
+    registry.on_construct<C>().disconnect(&changes);
+    registry.on_update<C>().disconnect(&changes);
+    registry.ctx().erase<ComponentChanges>();
+  }
+
+  // Stops listening to the signals while the storage is rewritten in bulk.
+  // Resume marks everything changed instead.
+  static void Suspend(Registry& registry)
+  {
+    ComponentChanges& changes = Get(registry);
+    registry.on_construct<C>().disconnect(&changes);
+    registry.on_update<C>().disconnect(&changes);
+  }
+
+  static void Resume(Registry& registry)
+  {
+    ComponentChanges& changes = Get(registry);
+    registry.on_construct<C>().template connect<&ComponentChanges::OnChange>(changes);
+    registry.on_update<C>().template connect<&ComponentChanges::OnChange>(changes);
+    changes.MarkAllChanged();
+  }
+
+  static ComponentChanges& Get(Registry& registry)
+  {
+    return registry.ctx().get<ComponentChanges>();
+  }
+
+private:
+  void OnChange(Registry& registry, entt::entity entity)
+  {
+    MarkChanged(entity);
+  }
+};
+
+} // namespace tk
+
+#endif // !TK_CHANGE_TRACKER_H
@@ -0,0 +1,130 @@
+#include "command_buffer.h"
+#include "core/threads/worker_thread.h"
+#include <algorithm>
+
+namespace tk
+{
+
+CommandBuffer::~CommandBuffer()
+{
+  Clear();
+}
+
+PendingEntity CommandBuffer::Create()
+{
+  PendingEntity entity{(u32)mPending.size()};
+  mPending.push_back(entt::null);
+  Push(entt::null, entity.Index, &ApplyCreate, nullptr, nullptr);
+  return entity;
+}
+
+void CommandBuffer::Clear()
+{
+  for (Command& command : mCommands)
+  {
+    if (command.Discard)
+    {
+      command.Discard(command.Payload);
+    }
+  }
+  Reset();
+}
+
+void CommandBuffer::Apply(Registry& registry, Command& command)
+{
+  entt::entity entity = command.Entity;
+  if (command.Pending != NoPending)
+  {
+    entt::entity& pending = mPending[command.Pending];
+    if (pending == entt::null)
+    {
+      pending = registry.create();
+    }
+    entity = pending;
+  }
+
+  if (registry.valid(entity))
+  {
+    command.Apply(registry, entity, command.Payload);
+  }
+  else if (command.Discard)
+  {
+    command.Discard(command.Payload);
+  }
+}
+
+void CommandBuffer::Reset()
+{
+  mCommands.clear();
+  mPending.clear();
+  mArena.Reset();
+  mSortKey = 0;
+}
+
+CommandQueue::CommandQueue(u32 numThreads)
+{
+  for (u32 i = 0; i <= numThreads; i++)
+  {
+    mBuffers.push_back(new CommandBuffer());
+  }
+}
+
+CommandQueue::~CommandQueue()
+{
+  for (CommandBuffer* buffer : mBuffers)
+  {
+    delete buffer;
+  }
+  mBuffers.clear();
+}
+
+CommandBuffer& CommandQueue::GetLocal()
+{
+  u32 shared = (u32)mBuffers.size() - 1;
+  WorkerThread* worker = WorkerThread::Current();
+  u32 index = worker && worker->GetId() >= 0 ? (u32)worker->GetId() : shared;
+  return *mBuffers[index < shared ? index : shared];
+}
+
+void CommandQueue::Playback(Registry& registry)
+{
+  mOrder.clear();
+  for (u32 b = 0; b < mBuffers.size(); b++)
+  {
+    const CommandBuffer& buffer = *mBuffers[b];
+    for (u32 i = 0; i < buffer.Size(); i++)
+    {
+      mOrder.push_back({buffer.mCommands[i].SortKey, b, i});
+    }
+  }
+  if (mOrder.empty())
+  {
+    return;
+  }
+
+  std::sort(mOrder.begin(), mOrder.end(), [](const Entry& lhs, const Entry& rhs) {
+    if (lhs.SortKey != rhs.SortKey)
+    {
+      return lhs.SortKey < rhs.SortKey;
+    }
+    return lhs.Buffer != rhs.Buffer ? lhs.Buffer < rhs.Buffer : lhs.Index < rhs.Index;
+  });
+
+  for (const Entry& entry : mOrder)
+  {
+    CommandBuffer& buffer = *mBuffers[entry.Buffer];
+    buffer.Apply(registry, buffer.mCommands[entry.Index]);
+  }
+
+  for (CommandBuffer* buffer : mBuffers)
+  {
+    buffer->Reset();
+  }
+}
+
+bool CommandQueue::Empty() const
+{
+  return std::all_of(mBuffers.begin(), mBuffers.end(), [](const CommandBuffer* buffer) { return buffer->Empty(); });
+}
+
+} // namespace tk
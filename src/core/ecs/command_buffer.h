@@ -0,0 +1,210 @@
+#ifndef TK_COMMAND_BUFFER_H
+#define TK_COMMAND_BUFFER_H
+
+#include "core/arena.h"
+#include "core/dynamic_array.h"
+#include "core/ecs/registry.h"
+#include <new>
+#include <type_traits>
+
+namespace tk
+{
+
+// Entity created by a CommandBuffer. It only exists once the buffer is played
+// back and can only be used with the buffer that created it.
+struct PendingEntity
+{
+  u32 Index = ~0u;
+};
+
+// Structural changes recorded for later: entity creation and destruction,
+// component emplace and removal. Components are moved into the buffer's arena
+// and moved out again on playback, so recording allocates nothing once the
+// arena has grown. Commands are ordered by the current sort key, see
+// CommandQueue.
+class CommandBuffer
+{
+  friend class CommandQueue;
+
+  static constexpr u32 NoPending = ~0u;
+
+  using ApplyFunc = void (*)(Registry& registry, entt::entity entity, void* payload);
+  using DiscardFunc = void (*)(void* payload);
+
+  struct Command
+  {
+    u64 SortKey = 0;
+    ApplyFunc Apply = nullptr;
+    DiscardFunc Discard = nullptr;
+    void* Payload = nullptr;
+    entt::entity Entity = entt::null;
+    u32 Pending = NoPending;
+  };
+
+  Arena mArena{};
+  DynamicArray<Command> mCommands = {};
+  // Entities behind PendingEntity indices, created on first use in playback.
+  DynamicArray<entt::entity> mPending = {};
+  u64 mSortKey = 0;
+
+public:
+  CommandBuffer() = default;
+  ~CommandBuffer();
+
+  CommandBuffer(const CommandBuffer&) = delete;
+  CommandBuffer& operator=(const CommandBuffer&) = delete;
+
+  // Commands recorded from now on are played back in the order of this key.
+  // Use something that doesn't depend on scheduling, like the entity being
+  // processed.
+  void SetSortKey(u64 key)
+  {
+    mSortKey = key;
+  }
+
+  u64 GetSortKey() const
+  {
+    return mSortKey;
+  }
+
+  PendingEntity Create();
+
+  void Destroy(entt::entity entity)
+  {
+    Push(entity, NoPending, &ApplyDestroy, nullptr, nullptr);
+  }
+
+  void Destroy(PendingEntity entity)
+  {
+    Push(entt::null, entity.Index, &ApplyDestroy, nullptr, nullptr);
+  }
+
+  // Adds the component, or replaces it if the entity has one by then.
+  template <typename C, typename... Args> void Emplace(entt::entity entity, Args&&... args)
+  {
+    PushEmplace<C>(entity, NoPending, std::forward<Args>(args)...);
+  }
+
+  template <typename C, typename... Args> void Emplace(PendingEntity entity, Args&&... args)
+  {
+    PushEmplace<C>(entt::null, entity.Index, std::forward<Args>(args)...);
+  }
+
+  template <typename C> void Remove(entt::entity entity)
+  {
+    Push(entity, NoPending, &ApplyRemove<C>, nullptr, nullptr);
+  }
+
+  template <typename C> void Remove(PendingEntity entity)
+  {
+    Push(entt::null, entity.Index, &ApplyRemove<C>, nullptr, nullptr);
+  }
+
+  bool Empty() const
+  {
+    return mCommands.empty();
+  }
+
+  u32 Size() const
+  {
+    return (u32)mCommands.size();
+  }
+
+  // Drops everything recorded without applying it.
+  void Clear();
+
+private:
+  void Push(entt::entity entity, u32 pending, ApplyFunc apply, DiscardFunc discard, void* payload)
+  {
+    mCommands.push_back({mSortKey, apply, discard, payload, entity, pending});
+  }
+
+  template <typename C, typename... Args> void PushEmplace(entt::entity entity, u32 pending, Args&&... args)
+  {
+    C* component = new (mArena.Allocate<C>()) C{std::forward<Args>(args)...};
+    DiscardFunc discard = std::is_trivially_destructible_v<C> ? nullptr : &Discard<C>;
+    Push(entity, pending, &ApplyEmplace<C>, discard, component);
+  }
+
+  // Applies command, resolving its pending entity. Commands on entities that
+  // are gone by then are skipped.
+  void Apply(Registry& registry, Command& command);
+  void Reset();
+
+  static void ApplyCreate(Registry& registry, entt::entity entity, void* payload)
+  {
+  }
+
+  static void ApplyDestroy(Registry& registry, entt::entity entity, void* payload)
+  {
+    registry.destroy(entity);
+  }
+
+  template <typename C> static void ApplyEmplace(Registry& registry, entt::entity entity, void* payload)
+  {
+    C* component = static_cast<C*>(payload);
+    registry.emplace_or_replace<C>(entity, std::move(*component));
+    component->~C();
+  }
+
+  template <typename C> static void ApplyRemove(Registry& registry, entt::entity entity, void* payload)
+  {
+    registry.remove<C>(entity);
+  }
+
+  template <typename C> static void Discard(void* payload)
+  {
+    static_cast<C*>(payload)->~C();
+  }
+};
+
+// One CommandBuffer per pool thread plus one shared by every other thread,
+// which in practice is the game thread. Systems record into the buffer of the
+// thread they run on without locking, Playback merges all of them ordered by
+// sort key, then by thread and recording order. With sort keys that are
+// unique across threads the result doesn't depend on scheduling.
+//
+// Lives in the registry context, the engine and every world play it back
+// after each system phase.
+class CommandQueue
+{
+  struct Entry
+  {
+    u64 SortKey;
+    u32 Buffer;
+    u32 Index;
+  };
+
+  DynamicArray<CommandBuffer*> mBuffers = {};
+  DynamicArray<Entry> mOrder = {};
+
+public:
+  explicit CommandQueue(u32 numThreads);
+  ~CommandQueue();
+
+  CommandQueue(const CommandQueue&) = delete;
+  CommandQueue& operator=(const CommandQueue&) = delete;
+
+  CommandBuffer& GetLocal();
+  void Playback(Registry& registry);
+  bool Empty() const;
+
+  static void Connect(Registry& registry, u32 numThreads)
+  {
+    registry.ctx().emplace<CommandQueue>(numThreads);
+  }
+
+  static void Disconnect(Registry& registry)
+  {
+    registry.ctx().erase<CommandQueue>();
+  }
+
+  static CommandQueue& Get(Registry& registry)
+  {
+    return registry.ctx().get<CommandQueue>();
+  }
+};
+
+} // namespace tk
+
+#endif // !TK_COMMAND_BUFFER_H
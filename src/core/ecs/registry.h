@@ -1,11 +1,14 @@
 #ifndef TK_REGISTRY_H
 #define TK_REGISTRY_H
 
+#include "core/pool_allocator.h"
 #include "entt.hpp"
 
 namespace tk
 {
-using Registry = entt::registry;
+// Storages allocate through the registry's allocator. Default constructed
+// registries use the global heap, worlds hand theirs a MemoryPool.
+using Registry = entt::basic_registry<entt::entity, PoolAllocator<entt::entity>>;
 }
 
 #endif // !TK_REGISTRY_H
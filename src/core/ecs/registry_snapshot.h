@@ -0,0 +1,298 @@
+#ifndef TK_REGISTRY_SNAPSHOT_H
+#define TK_REGISTRY_SNAPSHOT_H
+
+#include "core/ecs/registry.h"
+#include "core/ecs/snapshot_archive.h"
+#include "core/logger.h"
+#include <algorithm>
+
+namespace tk
+{
+
+// Binary snapshot of the entities of a registry and the listed components.
+//
+// Layout: a SnapshotHeader, then one section for the entity storage and one
+// per component in template order. Every section is a SnapshotSection
+// followed by its payload at the next SnapshotWriter::Alignment boundary.
+// The entity payload is entt's snapshot stream of the entity storage, so
+// identifiers, versions and the free list come back as they were. Trivially
+// copyable components are stored packed: their entity array and their
+// component array, each aligned, copied page by page out of the storage and
+// bulk inserted back. Other components use entt's per-element stream.
+//
+// Loading replaces the whole registry. Storages are refilled through their
+// signals, so systems that mirror components see a clear and a rebuild
+// unless they are suspended around the load, see CoreSystems::LoadSnapshot.
+template <typename... C> class RegistrySnapshot
+{
+  struct SnapshotHeader
+  {
+    u32 Magic = 0;
+    u32 Version = 0;
+    u32 NumSections = 0;
+    u32 Reserved = 0;
+  };
+
+  struct SnapshotSection
+  {
+    u32 Id = 0;
+    u32 ElementSize = 0;
+    u32 Count = 0;
+    u32 Packed = 0;
+    u64 Size = 0;
+    u64 Reserved = 0;
+  };
+
+  static constexpr u32 Magic = 0x4e534b54; // "TKSN"
+  static constexpr u32 Version = 1;
+  static constexpr u32 NumSections = sizeof...(C) + 1;
+
+  template <typename T>
+  static constexpr bool IsPacked = std::is_trivially_copyable_v<T> && !std::is_empty_v<T> &&
+                                   !entt::component_traits<T>::in_place_delete;
+
+public:
+  static void Save(const Registry& registry, DynamicArray<u8>& out)
+  {
+    out.clear();
+    SnapshotWriter writer(out);
+    writer(SnapshotHeader{Magic, Version, NumSections, 0});
+
+    // The stream entt::basic_snapshot writes for the entity storage, in one copy
+    // instead of one archive call per entity.
+    const auto& entities = *registry.storage<entt::entity>();
+    WriteSection<entt::entity>(writer, 0, false, [&entities, &writer]() {
+      writer((std::underlying_type_t<entt::entity>)entities.size());
+      writer((std::underlying_type_t<entt::entity>)entities.free_list());
+      writer.Write(entities.data(), entities.size() * sizeof(entt::entity));
+    });
+    (SaveComponent<C>(registry, writer), ...);
+  }
+
+  // The memory is only read during the call, it may be a mapped file. It has
+  // to be aligned like SnapshotWriter::Alignment for the packed arrays to be
+  // read in place. Returns false if the snapshot doesn't match the listed
+  // components, the registry is left alone if the header is wrong and is
+  // cleared if a section is.
+  static bool Load(Registry& registry, const u8* data, size_t size)
+  {
+    SnapshotReader reader(data, size);
+    SnapshotHeader header;
+    reader(header);
+    if (!reader.Ok() || header.Magic != Magic || header.Version != Version || header.NumSections != NumSections)
+    {
+      Logger::Error("Snapshot header doesn't match");
+      return false;
+    }
+
+    registry.clear();
+
+    SnapshotSection section;
+    SnapshotReader entities = ReadSection<entt::entity>(reader, section, false);
+    std::underlying_type_t<entt::entity> length = 0;
+    if (!entities.Ok() || !SnapshotReader(entities).Read(&length, sizeof(length)) ||
+        section.Size < 2 * sizeof(length) + (u64)length * sizeof(entt::entity))
+    {
+      Logger::Error("Snapshot entity section is corrupt");
+      return false;
+    }
+    entt::basic_snapshot_loader<Registry>{registry}.get<entt::entity>(entities);
+
+    bool bOk = (LoadComponent<C>(registry, reader) && ...);
+    if (!bOk)
+    {
+      Logger::Error("Snapshot component sections are corrupt");
+      registry.clear();
+    }
+    return bOk;
+  }
+
+  // Hash of the same state Save writes, computed in place. Peers running the
+  // same simulation get the same value, as long as the hashed components
+  // have no padding bytes.
+  static u64 Checksum(const Registry& registry)
+  {
+    SnapshotHasher hasher(Magic);
+    const auto& entities = *registry.storage<entt::entity>();
+    hasher((u64)entities.size());
+    hasher((u64)entities.free_list());
+    hasher.Write(entities.data(), entities.size() * sizeof(entt::entity));
+    (HashComponent<C>(registry, hasher), ...);
+    return hasher.Get();
+  }
+
+private:
+  template <typename T> static void HashComponent(const Registry& registry, SnapshotHasher& hasher)
+  {
+    const auto* storage = registry.storage<T>();
+    u32 count = storage ? (u32)storage->size() : 0;
+    hasher(entt::type_hash<T>::value());
+    hasher(count);
+    if (count == 0)
+    {
+      return;
+    }
+
+    hasher.Write(storage->data(), count * sizeof(entt::entity));
+    if constexpr (IsPacked<T>)
+    {
+      constexpr u32 PageSize = entt::component_traits<T>::page_size;
+      for (u32 i = 0; i < count; i += PageSize)
+      {
+        hasher.Write(storage->raw()[i / PageSize], std::min(PageSize, count - i) * sizeof(T));
+      }
+    }
+    else if constexpr (!std::is_empty_v<T>)
+    {
+      thread_local DynamicArray<u8> scratch;
+      scratch.clear();
+      SnapshotWriter writer(scratch);
+      entt::basic_snapshot<Registry>{registry}.get<T>(writer);
+      hasher.Write(scratch.data(), scratch.size());
+    }
+  }
+
+  template <typename T, typename Func> static void WriteSection(SnapshotWriter& writer, u32 count, bool bPacked, Func&& func)
+  {
+    SnapshotSection section{entt::type_hash<T>::value(), sizeof(T), count, bPacked};
+    size_t headerOffset = writer.Size();
+    writer(section);
+    writer.Align();
+
+    size_t begin = writer.Size();
+    func();
+    section.Size = writer.Size() - begin;
+    writer.WriteAt(headerOffset, &section, sizeof(section));
+    writer.Align();
+  }
+
+  // Returns a reader over the payload of the next section, failed if it isn't
+  // a section of T.
+  template <typename T>
+  static SnapshotReader ReadSection(SnapshotReader& reader, SnapshotSection& section, bool bPacked)
+  {
+    reader(section);
+    reader.Align();
+    const u8* payload = reader.View(section.Size);
+    reader.Align();
+
+    SnapshotReader sectionReader(payload, payload ? section.Size : 0);
+    if (!payload || section.Id != entt::type_hash<T>::value() || section.ElementSize != sizeof(T) ||
+        section.Packed != (u32)bPacked)
+    {
+      sectionReader.Fail();
+    }
+    return sectionReader;
+  }
+
+  template <typename T> static void SaveComponent(const Registry& registry, SnapshotWriter& writer)
+  {
+    const auto* storage = registry.storage<T>();
+    u32 count = storage ? (u32)storage->size() : 0;
+
+    if constexpr (IsPacked<T>)
+    {
+      WriteSection<T>(writer, count, true, [storage, count, &writer]() {
+        if (count == 0)
+        {
+          return;
+        }
+
+        writer.Write(storage->data(), count * sizeof(entt::entity));
+        writer.Align();
+
+        constexpr u32 PageSize = entt::component_traits<T>::page_size;
+        u8* components = writer.Append(count * sizeof(T));
+        for (u32 i = 0; i < count; i += PageSize)
+        {
+          std::memcpy(components + i * sizeof(T), storage->raw()[i / PageSize], std::min(PageSize, count - i) * sizeof(T));
+        }
+      });
+    }
+    else if constexpr (std::is_empty_v<T>)
+    {
+      WriteSection<T>(writer, count, false, [storage, count, &writer]() {
+        if (count != 0)
+        {
+          writer.Write(storage->data(), count * sizeof(entt::entity));
+        }
+      });
+    }
+    else
+    {
+      WriteSection<T>(writer, count, false, [&registry, &writer]() { entt::basic_snapshot<Registry>{registry}.get<T>(writer); });
+    }
+  }
+
+  template <typename T> static bool LoadComponent(Registry& registry, SnapshotReader& reader)
+  {
+    SnapshotSection section;
+    SnapshotReader payload = ReadSection<T>(reader, section, IsPacked<T>);
+    if (!payload.Ok())
+    {
+      return false;
+    }
+
+    auto& storage = registry.storage<T>();
+    storage.clear();
+
+    if constexpr (IsPacked<T> || std::is_empty_v<T>)
+    {
+      u32 count = section.Count;
+      if (count == 0)
+      {
+        return true;
+      }
+
+      const auto* entities = reinterpret_cast<const entt::entity*>(payload.View(count * sizeof(entt::entity)));
+      if (!entities || !std::all_of(entities, entities + count, [&registry](entt::entity e) { return registry.valid(e); }))
+      {
+        return false;
+      }
+
+      if constexpr (IsPacked<T>)
+      {
+        payload.Align();
+        const u8* components = payload.View(count * sizeof(T));
+        if (!components || (uintptr_t)components % alignof(T) != 0)
+        {
+          return false;
+        }
+        storage.insert(entities, entities + count, reinterpret_cast<const T*>(components));
+      }
+      else
+      {
+        storage.insert(entities, entities + count);
+      }
+      return true;
+    }
+    else
+    {
+      // Same stream as entt's snapshot loader, which can't be used here since
+      // it expects an empty entity storage.
+      std::underlying_type_t<entt::entity> length = 0;
+      payload(length);
+      for (entt::entity entity = entt::null; length && payload.Ok(); --length)
+      {
+        payload(entity);
+        if (entity == entt::null)
+        {
+          continue;
+        }
+
+        T component{};
+        payload(component);
+        if (!registry.valid(entity))
+        {
+          return false;
+        }
+        storage.emplace(entity, std::move(component));
+      }
+      return payload.Ok();
+    }
+  }
+};
+
+} // namespace tk
+
+#endif // !TK_REGISTRY_SNAPSHOT_H
@@ -0,0 +1,181 @@
+#include "shape_group.h"
+
+namespace tk
+{
+
+void ShapeGroup::Connect(Registry& registry)
+{
+  mRegistry = &registry;
+
+  // Signals call their listeners in reverse order of connection. Construct
+  // hooks are connected before the group is created so they run after it has
+  // appended the entity, destroy hooks after so they run while the entity is
+  // still inside.
+  registry.on_construct<CShape>().connect<&ShapeGroup::OnConstruct>(*this);
+  registry.on_construct<CTransform>().connect<&ShapeGroup::OnConstruct>(*this);
+  registry.on_construct<CPrevTransform>().connect<&ShapeGroup::OnConstruct>(*this);
+  registry.on_update<CShape>().connect<&ShapeGroup::OnShapeUpdate>(*this);
+
+  mGroup = registry.group<CShape, CTransform, CPrevTransform>();
+
+  registry.on_destroy<CShape>().connect<&ShapeGroup::OnDestroy>(*this);
+  registry.on_destroy<CTransform>().connect<&ShapeGroup::OnDestroy>(*this);
+  registry.on_destroy<CPrevTransform>().connect<&ShapeGroup::OnDestroy>(*this);
+
+  Rebuild();
+}
+
+void ShapeGroup::Disconnect()
+{
+  mRegistry->on_construct<CShape>().disconnect(this);
+  mRegistry->on_construct<CTransform>().disconnect(this);
+  mRegistry->on_construct<CPrevTransform>().disconnect(this);
+  mRegistry->on_update<CShape>().disconnect(this);
+  mRegistry->on_destroy<CShape>().disconnect(this);
+  mRegistry->on_destroy<CTransform>().disconnect(this);
+  mRegistry->on_destroy<CPrevTransform>().disconnect(this);
+  mRegistry = nullptr;
+}
+
+void ShapeGroup::Refresh()
+{
+  if (mGroup.size() != Size())
+  {
+    Rebuild();
+  }
+}
+
+void ShapeGroup::OnConstruct(Registry& registry, entt::entity entity)
+{
+  if (mGroup.contains(entity) && mGroup.size() == Size() + 1)
+  {
+    InsertTail((u32)registry.get<CShape>(entity).shape);
+  }
+}
+
+void ShapeGroup::OnDestroy(Registry& registry, entt::entity entity)
+{
+  if (mGroup.contains(entity) && mGroup.size() == Size())
+  {
+    // The group then swaps the entity with its own tail, which is a no-op.
+    MoveToTail((u32)registry.storage<CShape>().index(entity));
+    mStart[NumShapes]--;
+  }
+}
+
+void ShapeGroup::OnShapeUpdate(Registry& registry, entt::entity entity)
+{
+  if (!mGroup.contains(entity) || mGroup.size() != Size())
+  {
+    return;
+  }
+
+  u32 index = (u32)registry.storage<CShape>().index(entity);
+  u32 shape = (u32)registry.get<CShape>(entity).shape;
+  if (index >= mStart[shape] && index < mStart[shape + 1])
+  {
+    return;
+  }
+
+  MoveToTail(index);
+  mStart[NumShapes]--;
+  InsertTail(shape);
+}
+
+void ShapeGroup::Rebuild()
+{
+  mLayoutVersion++;
+
+  u32 counts[NumShapes] = {};
+  u32 size = (u32)mGroup.size();
+  for (u32 i = 0; i < size; i++)
+  {
+    counts[ShapeAt(i)]++;
+  }
+
+  mStart[0] = 0;
+  for (u32 shape = 0; shape < NumShapes; shape++)
+  {
+    mStart[shape + 1] = mStart[shape] + counts[shape];
+  }
+
+  // In-place bucket sort, every swap puts at least one entity in its range.
+  u32 next[NumShapes];
+  for (u32 shape = 0; shape < NumShapes; shape++)
+  {
+    next[shape] = mStart[shape];
+  }
+  for (u32 shape = 0; shape < NumShapes; shape++)
+  {
+    while (next[shape] < mStart[shape + 1])
+    {
+      u32 other = ShapeAt(next[shape]);
+      if (other == shape)
+      {
+        next[shape]++;
+      }
+      else
+      {
+        Swap(next[shape], next[other]++);
+      }
+    }
+  }
+}
+
+void ShapeGroup::InsertTail(u32 shape)
+{
+  // Rotate the entity down through the ranges above its own, each range hands
+  // its first entity over to its end.
+  u32 index = mStart[NumShapes]++;
+  for (u32 other = NumShapes - 1; other > shape; other--)
+  {
+    Swap(index, mStart[other]);
+    index = mStart[other]++;
+  }
+}
+
+void ShapeGroup::MoveToTail(u32 index)
+{
+  // Find the range by position, on a shape update the component already holds
+  // the new shape.
+  u32 shape = 0;
+  while (index >= mStart[shape + 1])
+  {
+    shape++;
+  }
+
+  Swap(index, mStart[shape + 1] - 1);
+  index = mStart[shape + 1] - 1;
+  for (u32 other = shape + 1; other < NumShapes; other++)
+  {
+    mStart[other]--;
+    Swap(index, mStart[other + 1] - 1);
+    index = mStart[other + 1] - 1;
+  }
+}
+
+void ShapeGroup::Swap(u32 lhs, u32 rhs)
+{
+  if (lhs == rhs)
+  {
+    return;
+  }
+
+  mLayoutVersion++;
+
+  // Owned storages share their packed order, swap all of them together.
+  auto& shapes = mRegistry->storage<CShape>();
+  entt::entity left = shapes.data()[lhs];
+  entt::entity right = shapes.data()[rhs];
+  shapes.swap_elements(left, right);
+  mRegistry->storage<CTransform>().swap_elements(left, right);
+  mRegistry->storage<CPrevTransform>().swap_elements(left, right);
+}
+
+u32 ShapeGroup::ShapeAt(u32 index) const
+{
+  const auto& shapes = mRegistry->storage<CShape>();
+  return (u32)shapes.get(shapes.data()[index]).shape;
+}
+
+} // namespace tk
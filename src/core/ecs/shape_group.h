@@ -0,0 +1,83 @@
+#ifndef TK_SHAPE_GROUP_H
+#define TK_SHAPE_GROUP_H
+
+#include "core/components/c_prev_transform.h"
+#include "core/components/c_shape.h"
+#include "core/components/c_transform2d.h"
+#include "core/ecs/registry.h"
+
+namespace tk
+{
+
+// Owning group of everything shape extraction reads, kept ordered by
+// CShape::shape so every shape is one contiguous range of the packed storages.
+// The order is repaired from registry hooks as entities join, leave or change
+// shape, each change costs at most one swap per shape instead of a sort.
+// Shape changes must go through registry.patch/replace to be noticed.
+class ShapeGroup
+{
+public:
+  using Group = decltype(std::declval<Registry&>().group<CShape, CTransform, CPrevTransform>());
+  static constexpr u32 NumShapes = (u32)EShape::NumShapes;
+
+private:
+  Registry* mRegistry = nullptr;
+  Group mGroup = {};
+  // mStart[s] is the first packed index holding shape s, mStart[NumShapes] is
+  // the group size.
+  u32 mStart[NumShapes + 1] = {};
+  // Bumped whenever an entity moves within the packed arrays.
+  u64 mLayoutVersion = 0;
+
+public:
+  void Connect(Registry& registry);
+  void Disconnect();
+
+  // Rebuilds the order from scratch if the hooks missed a change, e.g. when the
+  // group existed before Connect. Cheap when everything is in sync.
+  void Refresh();
+
+  const Group& GetGroup() const
+  {
+    return mGroup;
+  }
+
+  u32 Size() const
+  {
+    return mStart[NumShapes];
+  }
+
+  u64 GetLayoutVersion() const
+  {
+    return mLayoutVersion;
+  }
+
+  // Packed index range [Begin, End) of the given shape.
+  u32 Begin(EShape shape) const
+  {
+    return mStart[(u32)shape];
+  }
+
+  u32 End(EShape shape) const
+  {
+    return mStart[(u32)shape + 1];
+  }
+
+private:
+  void OnConstruct(Registry& registry, entt::entity entity);
+  void OnDestroy(Registry& registry, entt::entity entity);
+  void OnShapeUpdate(Registry& registry, entt::entity entity);
+
+  void Rebuild();
+  // Moves the entity at the group's tail into the range of its shape.
+  void InsertTail(u32 shape);
+  // Moves the entity at index to the group's tail, keeping every other shape
+  // range contiguous.
+  void MoveToTail(u32 index);
+  void Swap(u32 lhs, u32 rhs);
+  u32 ShapeAt(u32 index) const;
+};
+
+} // namespace tk
+
+#endif // !TK_SHAPE_GROUP_H
@@ -0,0 +1,207 @@
+#ifndef TK_SNAPSHOT_ARCHIVE_H
+#define TK_SNAPSHOT_ARCHIVE_H
+
+#include "core/dynamic_array.h"
+#include "core/types.h"
+#include <cstring>
+#include <type_traits>
+
+namespace tk
+{
+
+// Archives for entt's snapshot and snapshot loader. Values are raw bytes in
+// host order, trivially copyable types are copied as they are and anything
+// else goes through SnapshotWrite(archive, value) / SnapshotRead(archive,
+// value) overloads found by ADL.
+class SnapshotWriter
+{
+public:
+  // Bulk arrays start at multiples of this from the start of the snapshot, so
+  // a mapped snapshot can be read in place.
+  static constexpr size_t Alignment = 64;
+
+private:
+  DynamicArray<u8>& mBuffer;
+
+public:
+  explicit SnapshotWriter(DynamicArray<u8>& buffer) : mBuffer(buffer)
+  {
+  }
+
+  void Write(const void* data, size_t size)
+  {
+    size_t offset = mBuffer.size();
+    mBuffer.resize(offset + size);
+    std::memcpy(mBuffer.data() + offset, data, size);
+  }
+
+  // Reserves size bytes and returns where to write them.
+  u8* Append(size_t size)
+  {
+    size_t offset = mBuffer.size();
+    mBuffer.resize(offset + size);
+    return mBuffer.data() + offset;
+  }
+
+  // Overwrites bytes written earlier, e.g. a size only known afterwards.
+  void WriteAt(size_t offset, const void* data, size_t size)
+  {
+    std::memcpy(mBuffer.data() + offset, data, size);
+  }
+
+  void Align()
+  {
+    mBuffer.resize((mBuffer.size() + Alignment - 1) / Alignment * Alignment);
+  }
+
+  size_t Size() const
+  {
+    return mBuffer.size();
+  }
+
+  template <typename T> void operator()(const T& value)
+  {
+    if constexpr (std::is_trivially_copyable_v<T>)
+    {
+      Write(&value, sizeof(T));
+    }
+    else
+    {
+      SnapshotWrite(*this, value);
+    }
+  }
+};
+
+// Reads from memory the caller keeps alive, e.g. a mapped file. Reads past the
+// end fail the reader instead of touching memory, check Ok() once done.
+class SnapshotReader
+{
+  const u8* mData = nullptr;
+  size_t mSize = 0;
+  size_t mOffset = 0;
+  bool bOk = true;
+
+public:
+  SnapshotReader(const u8* data, size_t size) : mData(data), mSize(size)
+  {
+  }
+
+  bool Read(void* data, size_t size)
+  {
+    const u8* source = View(size);
+    if (source)
+    {
+      std::memcpy(data, source, size);
+    }
+    return source != nullptr;
+  }
+
+  // Points at the next size bytes without copying them.
+  const u8* View(size_t size)
+  {
+    if (!bOk || size > mSize - mOffset)
+    {
+      bOk = false;
+      return nullptr;
+    }
+    const u8* data = mData + mOffset;
+    mOffset += size;
+    return data;
+  }
+
+  void Align()
+  {
+    size_t offset = (mOffset + SnapshotWriter::Alignment - 1) / SnapshotWriter::Alignment * SnapshotWriter::Alignment;
+    if (offset > mSize)
+    {
+      bOk = false;
+      return;
+    }
+    mOffset = offset;
+  }
+
+  void Fail()
+  {
+    bOk = false;
+  }
+
+  bool Ok() const
+  {
+    return bOk;
+  }
+
+  template <typename T> void operator()(T& value)
+  {
+    if constexpr (std::is_trivially_copyable_v<T>)
+    {
+      if (!Read(&value, sizeof(T)))
+      {
+        value = {};
+      }
+    }
+    else
+    {
+      SnapshotRead(*this, value);
+    }
+  }
+};
+
+// 64-bit hash of the bytes a SnapshotWriter would write, without storing
+// them. Meant for comparing states between peers, not against attackers.
+class SnapshotHasher
+{
+  static constexpr u64 Prime0 = 0x9e3779b97f4a7c15ull;
+  static constexpr u64 Prime1 = 0xc2b2ae3d27d4eb4full;
+
+  u64 mHash = 0;
+
+public:
+  explicit SnapshotHasher(u64 seed = 0) : mHash(seed)
+  {
+  }
+
+  void Write(const void* data, size_t size)
+  {
+    const u8* bytes = static_cast<const u8*>(data);
+    size_t i = 0;
+    for (; i + sizeof(u64) <= size; i += sizeof(u64))
+    {
+      u64 word;
+      std::memcpy(&word, bytes + i, sizeof(word));
+      Mix(word);
+    }
+    u64 tail = 0;
+    if (i < size)
+    {
+      std::memcpy(&tail, bytes + i, size - i);
+    }
+    Mix(tail ^ (u64)size << 56);
+  }
+
+  template <typename T> void operator()(const T& value)
+  {
+    static_assert(std::is_trivially_copyable_v<T>, "Hash the serialized form of other types");
+    Write(&value, sizeof(T));
+  }
+
+  u64 Get() const
+  {
+    u64 hash = mHash;
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdull;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ull;
+    return hash ^ hash >> 33;
+  }
+
+private:
+  void Mix(u64 word)
+  {
+    mHash ^= word * Prime0;
+    mHash = (mHash << 31 | mHash >> 33) * Prime1;
+  }
+};
+
+} // namespace tk
+
+#endif // !TK_SNAPSHOT_ARCHIVE_H
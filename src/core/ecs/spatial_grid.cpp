@@ -0,0 +1,178 @@
+#include "spatial_grid.h"
+#include <algorithm>
+#include <cmath>
+
+namespace tk
+{
+
+SpatialGrid::SpatialGrid(f32 cellSize) : mBuckets(MinBuckets, InvalidIndex)
+{
+  SetCellSize(cellSize);
+}
+
+void SpatialGrid::SetCellSize(f32 cellSize)
+{
+  mCellSize = cellSize > 0.f ? cellSize : DefaultCellSize;
+  mInvCellSize = 1.f / mCellSize;
+
+  for (Node& node : mNodes)
+  {
+    node.CellX = CellOf(node.Position.x);
+    node.CellY = CellOf(node.Position.y);
+  }
+  Rehash((u32)mBuckets.size());
+}
+
+void SpatialGrid::Set(entt::entity entity, const v2& position)
+{
+  u32 index = IndexOf(entity);
+  if (index == InvalidIndex)
+  {
+    u32 slot = entt::to_entity(entity);
+    if (slot >= mIndices.size())
+    {
+      mIndices.resize(slot + 1, InvalidIndex);
+    }
+    index = Size();
+    mIndices[slot] = index;
+    mNodes.push_back({entity, position, CellOf(position.x), CellOf(position.y)});
+
+    // Keep buckets at least as many as entities so chains stay short.
+    if (Size() > mBuckets.size())
+    {
+      Rehash((u32)mBuckets.size() * 2);
+    }
+    else
+    {
+      Link(index);
+    }
+    return;
+  }
+
+  Node& node = mNodes[index];
+  node.Position = position;
+  i32 x = CellOf(position.x);
+  i32 y = CellOf(position.y);
+  if (x == node.CellX && y == node.CellY)
+  {
+    return;
+  }
+
+  node.CellX = x;
+  node.CellY = y;
+  if (BucketOf(x, y) != node.Bucket)
+  {
+    Unlink(index);
+    Link(index);
+  }
+}
+
+void SpatialGrid::Remove(entt::entity entity)
+{
+  u32 index = IndexOf(entity);
+  if (index == InvalidIndex)
+  {
+    return;
+  }
+
+  Unlink(index);
+  mIndices[entt::to_entity(entity)] = InvalidIndex;
+
+  u32 last = Size() - 1;
+  if (index != last)
+  {
+    // Move the last node into the hole and point its neighbours at it.
+    Node& node = mNodes[index];
+    node = mNodes[last];
+    if (node.Prev != InvalidIndex)
+    {
+      mNodes[node.Prev].Next = index;
+    }
+    else
+    {
+      mBuckets[node.Bucket] = index;
+    }
+    if (node.Next != InvalidIndex)
+    {
+      mNodes[node.Next].Prev = index;
+    }
+    mIndices[entt::to_entity(node.Entity)] = index;
+  }
+  mNodes.pop_back();
+}
+
+void SpatialGrid::Clear()
+{
+  mNodes.clear();
+  mIndices.clear();
+  std::fill(mBuckets.begin(), mBuckets.end(), InvalidIndex);
+}
+
+bool SpatialGrid::Contains(entt::entity entity) const
+{
+  return IndexOf(entity) != InvalidIndex;
+}
+
+i32 SpatialGrid::CellOf(f32 coordinate) const
+{
+  f32 cell = std::floor(coordinate * mInvCellSize);
+  // Written so NaN ends up in cell 0 instead of undefined behaviour.
+  if (!(cell > (f32)-MaxCell))
+  {
+    return cell < 0.f ? -MaxCell : 0;
+  }
+  return cell < (f32)MaxCell ? (i32)cell : MaxCell;
+}
+
+u32 SpatialGrid::IndexOf(entt::entity entity) const
+{
+  u32 slot = entt::to_entity(entity);
+  if (slot >= mIndices.size())
+  {
+    return InvalidIndex;
+  }
+  u32 index = mIndices[slot];
+  return index != InvalidIndex && mNodes[index].Entity == entity ? index : InvalidIndex;
+}
+
+void SpatialGrid::Link(u32 index)
+{
+  Node& node = mNodes[index];
+  node.Bucket = BucketOf(node.CellX, node.CellY);
+  node.Prev = InvalidIndex;
+  node.Next = mBuckets[node.Bucket];
+  if (node.Next != InvalidIndex)
+  {
+    mNodes[node.Next].Prev = index;
+  }
+  mBuckets[node.Bucket] = index;
+}
+
+void SpatialGrid::Unlink(u32 index)
+{
+  Node& node = mNodes[index];
+  if (node.Prev != InvalidIndex)
+  {
+    mNodes[node.Prev].Next = node.Next;
+  }
+  else
+  {
+    mBuckets[node.Bucket] = node.Next;
+  }
+  if (node.Next != InvalidIndex)
+  {
+    mNodes[node.Next].Prev = node.Prev;
+  }
+  node.Prev = node.Next = InvalidIndex;
+}
+
+void SpatialGrid::Rehash(u32 numBuckets)
+{
+  mBuckets.assign(std::max(numBuckets, MinBuckets), InvalidIndex);
+  for (u32 i = 0; i < Size(); i++)
+  {
+    Link(i);
+  }
+}
+
+} // namespace tk
@@ -0,0 +1,148 @@
+#ifndef TK_SPATIAL_GRID_H
+#define TK_SPATIAL_GRID_H
+
+#include "core/dynamic_array.h"
+#include "core/ecs/registry.h"
+#include "core/types.h"
+
+namespace tk
+{
+
+// Uniform grid over 2D positions, hashed so it is unbounded and only costs
+// memory for occupied cells. Every entity is a node linked into the bucket of
+// its cell, moving within a cell only updates the position and crossing into
+// another cell relinks the node. Several cells may share a bucket, queries
+// filter by cell. Queries call back into the caller and never allocate.
+class SpatialGrid
+{
+public:
+  static constexpr f32 DefaultCellSize = 1.f;
+
+private:
+  static constexpr u32 InvalidIndex = ~0u;
+  static constexpr u32 MinBuckets = 256;
+  // Cell coordinates are clamped so far away positions can't overflow them.
+  static constexpr i32 MaxCell = 1 << 30;
+
+  struct Node
+  {
+    entt::entity Entity = entt::null;
+    v2 Position = v2(0.f);
+    i32 CellX = 0;
+    i32 CellY = 0;
+    u32 Bucket = InvalidIndex;
+    u32 Next = InvalidIndex;
+    u32 Prev = InvalidIndex;
+  };
+
+  DynamicArray<Node> mNodes = {};
+  // First node of every bucket.
+  DynamicArray<u32> mBuckets = {};
+  DynamicArray<u32> mIndices = {};
+  f32 mCellSize = DefaultCellSize;
+  f32 mInvCellSize = 1.f / DefaultCellSize;
+
+public:
+  SpatialGrid(f32 cellSize = DefaultCellSize);
+
+  // Rebuckets every entity, best picked close to the usual query radius.
+  void SetCellSize(f32 cellSize);
+
+  f32 GetCellSize() const
+  {
+    return mCellSize;
+  }
+
+  // Adds the entity or moves it if it is already in the grid.
+  void Set(entt::entity entity, const v2& position);
+  void Remove(entt::entity entity);
+  void Clear();
+  bool Contains(entt::entity entity) const;
+
+  u32 Size() const
+  {
+    return (u32)mNodes.size();
+  }
+
+  // Calls func(entity, position) for every entity inside the box, bounds
+  // included.
+  template <typename Func> void QueryAABB(const v2& min, const v2& max, Func&& func) const
+  {
+    Query(min, max, [&min, &max, &func](const Node& node) {
+      if (node.Position.x >= min.x && node.Position.x <= max.x && node.Position.y >= min.y &&
+          node.Position.y <= max.y)
+      {
+        func(node.Entity, node.Position);
+      }
+    });
+  }
+
+  // Calls func(entity, position) for every entity within radius of center.
+  template <typename Func> void QueryRadius(const v2& center, f32 radius, Func&& func) const
+  {
+    f32 radiusSq = radius * radius;
+    Query(center - v2(radius), center + v2(radius), [&center, radiusSq, &func](const Node& node) {
+      f32 dx = node.Position.x - center.x;
+      f32 dy = node.Position.y - center.y;
+      if (dx * dx + dy * dy <= radiusSq)
+      {
+        func(node.Entity, node.Position);
+      }
+    });
+  }
+
+private:
+  // Visits every node whose cell overlaps the box.
+  template <typename Visit> void Query(const v2& min, const v2& max, Visit&& visit) const
+  {
+    if (mNodes.empty() || !(min.x <= max.x && min.y <= max.y))
+    {
+      return;
+    }
+
+    i32 x0 = CellOf(min.x), x1 = CellOf(max.x);
+    i32 y0 = CellOf(min.y), y1 = CellOf(max.y);
+
+    // Walking more cells than there are entities is slower than looking at
+    // every entity. Spans are computed in i64, cells go up to +-MaxCell.
+    if ((u64)((i64)x1 - (i64)x0 + 1) * (u64)((i64)y1 - (i64)y0 + 1) > mNodes.size())
+    {
+      for (const Node& node : mNodes)
+      {
+        visit(node);
+      }
+      return;
+    }
+
+    for (i32 y = y0; y <= y1; y++)
+    {
+      for (i32 x = x0; x <= x1; x++)
+      {
+        for (u32 n = mBuckets[BucketOf(x, y)]; n != InvalidIndex; n = mNodes[n].Next)
+        {
+          const Node& node = mNodes[n];
+          if (node.CellX == x && node.CellY == y)
+          {
+            visit(node);
+          }
+        }
+      }
+    }
+  }
+
+  i32 CellOf(f32 coordinate) const;
+
+  u32 BucketOf(i32 x, i32 y) const
+  {
+    return ((u32)x * 73856093u ^ (u32)y * 19349663u) & ((u32)mBuckets.size() - 1);
+  }
+
+  u32 IndexOf(entt::entity entity) const;
+  void Link(u32 index);
+  void Unlink(u32 index);
+  void Rehash(u32 numBuckets);
+};
+
+} // namespace tk
+
+#endif // !TK_SPATIAL_GRID_H
@@ -0,0 +1,217 @@
+#include "transform_hierarchy.h"
+#include "core/math/transform_kernels.h"
+#include <algorithm>
+
+namespace tk
+{
+
+void TransformHierarchy::Build(Registry& registry)
+{
+  Clear();
+
+  auto& parents = registry.storage<CParent>();
+  auto& locals = registry.storage<CLocalTransform>();
+  auto& transforms = registry.storage<CTransform>();
+
+  // Live parent of the entity, null for roots and entities whose parent is gone.
+  auto parentOf = [&registry, &parents](entt::entity entity) {
+    if (!parents.contains(entity))
+    {
+      return entt::entity{entt::null};
+    }
+    entt::entity parent = parents.get(entity).Parent;
+    return parent != entity && registry.valid(parent) ? parent : entt::entity{entt::null};
+  };
+
+  // Group children by parent slot: count, prefix sum, then fill backwards so
+  // mChildStart ends up holding the first child of every slot.
+  u32 numSlots = 0;
+  for (auto [child, link] : parents.each())
+  {
+    if (entt::entity parent = parentOf(child); parent != entt::null)
+    {
+      numSlots = std::max(numSlots, (u32)entt::to_entity(parent) + 1);
+    }
+  }
+
+  mChildStart.assign(numSlots + 1, 0);
+  for (auto [child, link] : parents.each())
+  {
+    if (entt::entity parent = parentOf(child); parent != entt::null)
+    {
+      mChildStart[entt::to_entity(parent)]++;
+    }
+  }
+  for (u32 slot = 1; slot <= numSlots; slot++)
+  {
+    mChildStart[slot] += mChildStart[slot - 1];
+  }
+  mChildren.resize(mChildStart[numSlots]);
+  for (auto [child, link] : parents.each())
+  {
+    if (entt::entity parent = parentOf(child); parent != entt::null)
+    {
+      mChildren[--mChildStart[entt::to_entity(parent)]] = child;
+    }
+  }
+
+  const CTransform identity = {v2(0.f), 0.f, 1.f};
+  for (auto [child, link] : parents.each())
+  {
+    entt::entity parent = parentOf(child);
+    if (parent != entt::null && parentOf(parent) == entt::null && IndexOf(parent) == InvalidIndex)
+    {
+      AddNode(parent, InvalidIndex, {}, transforms.contains(parent) ? transforms.get(parent) : identity);
+    }
+  }
+
+  // Breadth-first: the children of level l, in the order of their parents,
+  // form level l + 1.
+  mLevels.push_back(0);
+  for (u32 begin = 0; begin < Size();)
+  {
+    u32 end = Size();
+    mLevels.push_back(end);
+    for (u32 i = begin; i < end; i++)
+    {
+      u32 slot = entt::to_entity(mEntities[i]);
+      if (slot >= numSlots)
+      {
+        continue;
+      }
+
+      for (u32 c = mChildStart[slot]; c < mChildStart[slot + 1]; c++)
+      {
+        entt::entity child = mChildren[c];
+        AddNode(child, i, locals.contains(child) ? locals.get(child) : CLocalTransform{},
+                transforms.contains(child) ? transforms.get(child) : identity);
+      }
+    }
+    begin = end;
+  }
+}
+
+void TransformHierarchy::Clear()
+{
+  mEntities.clear();
+  mParents.clear();
+  mLocals.clear();
+  mWorld.clear();
+  mAxes.clear();
+  mMoved.clear();
+  mLevels.clear();
+  mIndices.clear();
+}
+
+void TransformHierarchy::SetLocal(entt::entity entity, const CLocalTransform& local)
+{
+  u32 index = IndexOf(entity);
+  if (index != InvalidIndex && mParents[index] != InvalidIndex)
+  {
+    mLocals[index] = local;
+  }
+}
+
+void TransformHierarchy::ReadLocals(Registry& registry)
+{
+  auto& locals = registry.storage<CLocalTransform>();
+  for (u32 i = GetNumLevels() > 0 ? LevelEnd(0) : 0; i < Size(); i++)
+  {
+    mLocals[i] = locals.contains(mEntities[i]) ? locals.get(mEntities[i]) : CLocalTransform{};
+  }
+}
+
+bool TransformHierarchy::Contains(entt::entity entity) const
+{
+  return IndexOf(entity) != InvalidIndex;
+}
+
+void TransformHierarchy::GatherRoots(Registry& registry, u32 begin, u32 end)
+{
+  auto& transforms = registry.storage<CTransform>();
+  for (u32 i = begin; i < end; i++)
+  {
+    if (transforms.contains(mEntities[i]))
+    {
+      SetWorld(i, transforms.get(mEntities[i]));
+    }
+  }
+}
+
+void TransformHierarchy::Propagate(Registry& registry, u32 begin, u32 end)
+{
+  auto& transforms = registry.storage<CTransform>();
+  for (u32 i = begin; i < end; i++)
+  {
+    const CTransform& parent = mWorld[mParents[i]];
+    const v2& axis = mAxes[mParents[i]];
+    const CLocalTransform& local = mLocals[i];
+
+    CTransform world;
+    world.Position = parent.Position + v2(axis.x * local.Position.x - axis.y * local.Position.y,
+                                          axis.y * local.Position.x + axis.x * local.Position.y);
+    world.Rotation = parent.Rotation + local.Rotation;
+    world.Scale = parent.Scale * local.Scale;
+
+    if (!IsSame(world, mWorld[i]))
+    {
+      SetWorld(i, world);
+    }
+
+    // Compared against CTransform rather than the cached world transform, so
+    // writes from other systems, like SIntegrate moving a child that has a
+    // CVelocity, are undone too.
+    mMoved[i] = false;
+    if (transforms.contains(mEntities[i]))
+    {
+      CTransform& transform = transforms.get(mEntities[i]);
+      mMoved[i] = !IsSame(transform, mWorld[i]);
+      transform = mWorld[i];
+    }
+  }
+}
+
+void TransformHierarchy::AddNode(entt::entity entity, u32 parent, const CLocalTransform& local,
+                                 const CTransform& world)
+{
+  u32 slot = entt::to_entity(entity);
+  if (slot >= mIndices.size())
+  {
+    mIndices.resize(slot + 1, InvalidIndex);
+  }
+  mIndices[slot] = Size();
+
+  mEntities.push_back(entity);
+  mParents.push_back(parent);
+  mLocals.push_back(local);
+  mWorld.emplace_back();
+  mAxes.emplace_back();
+  mMoved.push_back(false);
+  SetWorld(Size() - 1, world);
+}
+
+u32 TransformHierarchy::IndexOf(entt::entity entity) const
+{
+  u32 slot = entt::to_entity(entity);
+  if (slot >= mIndices.size())
+  {
+    return InvalidIndex;
+  }
+  u32 index = mIndices[slot];
+  return index != InvalidIndex && mEntities[index] == entity ? index : InvalidIndex;
+}
+
+bool TransformHierarchy::IsSame(const CTransform& a, const CTransform& b)
+{
+  return a.Position == b.Position && a.Rotation == b.Rotation && a.Scale == b.Scale;
+}
+
+void TransformHierarchy::SetWorld(u32 index, const CTransform& world)
+{
+  mWorld[index] = world;
+  f32 sin, cos;
+  TransformKernels::SinCos(world.Rotation, sin, cos);
+  mAxes[index] = world.Scale * v2(cos, sin);
+}
+
+} // namespace tk
@@ -0,0 +1,105 @@
+#ifndef TK_TRANSFORM_HIERARCHY_H
+#define TK_TRANSFORM_HIERARCHY_H
+
+#include "core/components/c_local_transform.h"
+#include "core/components/c_parent.h"
+#include "core/components/c_transform2d.h"
+#include "core/dynamic_array.h"
+#include "core/ecs/registry.h"
+
+namespace tk
+{
+
+// Flattened CParent tree. Nodes are stored breadth-first in dense arrays:
+// the roots, then every level right after the one above it, with the children
+// of a parent next to each other. A node only reads its parent's node, which
+// sits in the previous level, so a level is one contiguous range that can be
+// split across threads once the level above is done, without touching the
+// registry.
+//
+// Roots are entities with children but without a (live) parent, their world
+// transform is their own CTransform. Parent cycles are never reached from a
+// root and are left alone.
+class TransformHierarchy
+{
+  static constexpr u32 InvalidIndex = ~0u;
+
+  DynamicArray<entt::entity> mEntities = {};
+  // Node index of the parent, InvalidIndex for roots.
+  DynamicArray<u32> mParents = {};
+  DynamicArray<CLocalTransform> mLocals = {};
+  DynamicArray<CTransform> mWorld = {};
+  // World x axis of the node, rotated and scaled, reused by all its children.
+  DynamicArray<v2> mAxes = {};
+  // Whether the last Propagate wrote the node's CTransform.
+  DynamicArray<u8> mMoved = {};
+  // mLevels[l] is the first node of level l, the last entry is the node count.
+  DynamicArray<u32> mLevels = {};
+  DynamicArray<u32> mIndices = {};
+
+  // Build scratch, kept to avoid reallocating on every rebuild.
+  DynamicArray<u32> mChildStart = {};
+  DynamicArray<entt::entity> mChildren = {};
+
+public:
+  // Rebuilds every level from the CParent storage.
+  void Build(Registry& registry);
+  void Clear();
+
+  void SetLocal(entt::entity entity, const CLocalTransform& local);
+  // Reloads every local transform, for when their changes were missed.
+  void ReadLocals(Registry& registry);
+  bool Contains(entt::entity entity) const;
+
+  u32 Size() const
+  {
+    return (u32)mEntities.size();
+  }
+
+  // Level 0 holds the roots.
+  u32 GetNumLevels() const
+  {
+    return mLevels.empty() ? 0 : (u32)mLevels.size() - 1;
+  }
+
+  u32 LevelBegin(u32 level) const
+  {
+    return mLevels[level];
+  }
+
+  u32 LevelEnd(u32 level) const
+  {
+    return mLevels[level + 1];
+  }
+
+  // Range versions so callers can split a level with ParallelFor.
+  // Reads the world transform of the roots in [begin, end).
+  void GatherRoots(Registry& registry, u32 begin, u32 end);
+  // Computes the world transform of the nodes in [begin, end), which must be
+  // within one level whose parent level is up to date. Nodes whose CTransform
+  // differs from it are written without triggering its update signal.
+  void Propagate(Registry& registry, u32 begin, u32 end);
+
+  // Calls func(entity) for every non-root node whose CTransform the last
+  // Propagate wrote.
+  template <typename Func> void ForEachMoved(Func&& func) const
+  {
+    for (u32 i = GetNumLevels() > 0 ? LevelEnd(0) : 0; i < Size(); i++)
+    {
+      if (mMoved[i])
+      {
+        func(mEntities[i]);
+      }
+    }
+  }
+
+private:
+  void AddNode(entt::entity entity, u32 parent, const CLocalTransform& local, const CTransform& world);
+  u32 IndexOf(entt::entity entity) const;
+  void SetWorld(u32 index, const CTransform& world);
+  static bool IsSame(const CTransform& a, const CTransform& b);
+};
+
+} // namespace tk
+
+#endif // !TK_TRANSFORM_HIERARCHY_H
@@ -0,0 +1,152 @@
+#include "transform_soa.h"
+
+namespace tk
+{
+
+void TransformSoA::Add(entt::entity entity, const CTransform& transform, const CVelocity& velocity)
+{
+  if (Contains(entity))
+  {
+    SetTransform(entity, transform);
+    SetVelocity(entity, velocity);
+    return;
+  }
+
+  u32 slot = entt::to_entity(entity);
+  if (slot >= mIndices.size())
+  {
+    mIndices.resize(slot + 1, InvalidIndex);
+  }
+  mIndices[slot] = Size();
+
+  mEntities.push_back(entity);
+  mPositionX.push_back(transform.Position.x);
+  mPositionY.push_back(transform.Position.y);
+  mRotation.push_back(transform.Rotation);
+  mScale.push_back(transform.Scale);
+  mVelocityX.push_back(velocity.Linear.x);
+  mVelocityY.push_back(velocity.Linear.y);
+  mAngularVelocity.push_back(velocity.Angular);
+}
+
+void TransformSoA::Remove(entt::entity entity)
+{
+  u32 index = IndexOf(entity);
+  if (index == InvalidIndex)
+  {
+    return;
+  }
+
+  u32 last = Size() - 1;
+  mIndices[entt::to_entity(mEntities[last])] = index;
+  mIndices[entt::to_entity(entity)] = InvalidIndex;
+
+  mEntities[index] = mEntities[last];
+  mPositionX[index] = mPositionX[last];
+  mPositionY[index] = mPositionY[last];
+  mRotation[index] = mRotation[last];
+  mScale[index] = mScale[last];
+  mVelocityX[index] = mVelocityX[last];
+  mVelocityY[index] = mVelocityY[last];
+  mAngularVelocity[index] = mAngularVelocity[last];
+
+  mEntities.pop_back();
+  mPositionX.pop_back();
+  mPositionY.pop_back();
+  mRotation.pop_back();
+  mScale.pop_back();
+  mVelocityX.pop_back();
+  mVelocityY.pop_back();
+  mAngularVelocity.pop_back();
+}
+
+void TransformSoA::Clear()
+{
+  mEntities.clear();
+  mIndices.clear();
+  mPositionX.clear();
+  mPositionY.clear();
+  mRotation.clear();
+  mScale.clear();
+  mVelocityX.clear();
+  mVelocityY.clear();
+  mAngularVelocity.clear();
+}
+
+bool TransformSoA::Contains(entt::entity entity) const
+{
+  return IndexOf(entity) != InvalidIndex;
+}
+
+void TransformSoA::SetTransform(entt::entity entity, const CTransform& transform)
+{
+  u32 index = IndexOf(entity);
+  if (index != InvalidIndex)
+  {
+    mPositionX[index] = transform.Position.x;
+    mPositionY[index] = transform.Position.y;
+    mRotation[index] = transform.Rotation;
+    mScale[index] = transform.Scale;
+  }
+}
+
+void TransformSoA::SetVelocity(entt::entity entity, const CVelocity& velocity)
+{
+  u32 index = IndexOf(entity);
+  if (index != InvalidIndex)
+  {
+    mVelocityX[index] = velocity.Linear.x;
+    mVelocityY[index] = velocity.Linear.y;
+    mAngularVelocity[index] = velocity.Angular;
+  }
+}
+
+void TransformSoA::Integrate(u32 begin, u32 end, f32 deltaTime)
+{
+  TransformKernels::IntegrateVelocity(mPositionX.data() + begin, mPositionY.data() + begin, mRotation.data() + begin,
+                                      mVelocityX.data() + begin, mVelocityY.data() + begin,
+                                      mAngularVelocity.data() + begin, end - begin, deltaTime);
+}
+
+void TransformSoA::BuildModelMatrices(u32 begin, u32 end, Affine2D* outMatrices) const
+{
+  TransformKernels::BuildModelMatrices(mPositionX.data() + begin, mPositionY.data() + begin, mRotation.data() + begin,
+                                       mScale.data() + begin, end - begin, outMatrices + begin);
+}
+
+void TransformSoA::WriteBack(Registry& registry, u32 begin, u32 end) const
+{
+  auto& transforms = registry.storage<CTransform>();
+  for (u32 i = begin; i < end; i++)
+  {
+    CTransform& transform = transforms.get(mEntities[i]);
+    transform.Position = v2(mPositionX[i], mPositionY[i]);
+    transform.Rotation = mRotation[i];
+  }
+}
+
+void TransformSoA::ReadTransforms(Registry& registry)
+{
+  auto& transforms = registry.storage<CTransform>();
+  for (u32 i = 0; i < Size(); i++)
+  {
+    const CTransform& transform = transforms.get(mEntities[i]);
+    mPositionX[i] = transform.Position.x;
+    mPositionY[i] = transform.Position.y;
+    mRotation[i] = transform.Rotation;
+    mScale[i] = transform.Scale;
+  }
+}
+
+u32 TransformSoA::IndexOf(entt::entity entity) const
+{
+  u32 slot = entt::to_entity(entity);
+  if (slot >= mIndices.size())
+  {
+    return InvalidIndex;
+  }
+  u32 index = mIndices[slot];
+  return index != InvalidIndex && mEntities[index] == entity ? index : InvalidIndex;
+}
+
+} // namespace tk
@@ -0,0 +1,67 @@
+#ifndef TK_TRANSFORM_SOA_H
+#define TK_TRANSFORM_SOA_H
+
+#include "core/aligned_allocator.h"
+#include "core/components/c_transform2d.h"
+#include "core/components/c_velocity.h"
+#include "core/dynamic_array.h"
+#include "core/ecs/registry.h"
+#include "core/math/transform_kernels.h"
+
+namespace tk
+{
+
+// Structure-of-arrays copy of CTransform and CVelocity for the entities that
+// have both. Every field is its own dense, 32-byte aligned array so the SIMD
+// kernels stream through them. Removal swaps the last entity in.
+class TransformSoA
+{
+  static constexpr size_t Alignment = 32;
+  static constexpr u32 InvalidIndex = ~0u;
+
+  AlignedArray<f32, Alignment> mPositionX = {};
+  AlignedArray<f32, Alignment> mPositionY = {};
+  AlignedArray<f32, Alignment> mRotation = {};
+  AlignedArray<f32, Alignment> mScale = {};
+  AlignedArray<f32, Alignment> mVelocityX = {};
+  AlignedArray<f32, Alignment> mVelocityY = {};
+  AlignedArray<f32, Alignment> mAngularVelocity = {};
+  DynamicArray<entt::entity> mEntities = {};
+  DynamicArray<u32> mIndices = {};
+
+public:
+  void Add(entt::entity entity, const CTransform& transform, const CVelocity& velocity);
+  void Remove(entt::entity entity);
+  void Clear();
+  bool Contains(entt::entity entity) const;
+
+  void SetTransform(entt::entity entity, const CTransform& transform);
+  void SetVelocity(entt::entity entity, const CVelocity& velocity);
+
+  u32 Size() const
+  {
+    return (u32)mEntities.size();
+  }
+
+  const entt::entity* GetEntities() const
+  {
+    return mEntities.data();
+  }
+
+  // Range versions so callers can split the work with ParallelFor.
+  void Integrate(u32 begin, u32 end, f32 deltaTime);
+  void BuildModelMatrices(u32 begin, u32 end, Affine2D* outMatrices) const;
+  // Copies the range back into the registry's CTransform without triggering
+  // its update signal.
+  void WriteBack(Registry& registry, u32 begin, u32 end) const;
+  // Reloads every transform from the registry, for when its changes were
+  // missed.
+  void ReadTransforms(Registry& registry);
+
+private:
+  u32 IndexOf(entt::entity entity) const;
+};
+
+} // namespace tk
+
+#endif // !TK_TRANSFORM_SOA_H
@@ -1,11 +1,12 @@
 #ifndef TK_VIEW_H
 #define TK_VIEW_H
 
-#include "entt.hpp"
+#include "registry.h"
+#include <utility>
 
 namespace tk
 {
-template <typename T> using View = entt::view<T>;
+template <typename T> using View = decltype(std::declval<Registry&>().view<T>());
 }
 
 #endif // !TK_VIEW_H
@@ -1,22 +1,71 @@
 #include "engine.h"
 
+#include "core/ecs/command_buffer.h"
+#include "core/lockstep.h"
 #include "core/renderer.h"
+#include "core/systems/core_systems.h"
 #include "core/window.h"
 #include "logger.h"
-#include "systems/update/s_shape.h"
+#include "systems/system_scheduler.h"
 #include "systems/update/update_system.h"
+#include "threads/thread_pool.h"
 #include <cstring>
 
 namespace tk
 {
 
+Engine* Engine::mInstance = nullptr;
+
 Engine::Engine() : bRunning(false)
 {
+  mInstance = this;
 }
 
 Engine& Engine::Get()
 {
-  return mInstance;
+  return *mInstance;
+}
+
+Registry& Engine::GetRegistry()
+{
+  return mRegistry;
+}
+
+ThreadPool& Engine::GetThreadPool()
+{
+  return *mThreadPool;
+}
+
+void Engine::AddSystem(SUpdate* system)
+{
+  system->Init();
+  mUpdateSystems.emplace_back(system);
+  mScheduler->Add(system);
+}
+
+const SystemPhaseTimings& Engine::GetPhaseTimings() const
+{
+  return mSystems->GetTimings();
+}
+
+const SystemProfiler& Engine::GetSystemProfiler() const
+{
+  return mProfiler;
+}
+
+const SimulationClock& Engine::GetSimulationClock() const
+{
+  return mClock;
+}
+
+void Engine::SaveSnapshot(DynamicArray<u8>& out) const
+{
+  CoreSnapshot::Save(mRegistry, out);
+}
+
+bool Engine::LoadSnapshot(const u8* data, size_t size)
+{
+  return mSystems->LoadSnapshot(mRegistry, data, size);
 }
 
 void Engine::Init()
@@ -25,22 +74,86 @@ void Engine::Init()
 
   bRunning = true;
 
+  ThreadPoolConfig config{};
+  ConfigureThreadPool(config);
+  mThreadPool = new ThreadPool(config);
+  mThreadPool->Run();
+
+  SimulationConfig simulation{};
+  ConfigureSimulation(simulation);
+  mClock = SimulationClock(simulation);
+
+  ConfigureProfiler(mProfilerConfig);
+
+  LockstepConfig lockstep{};
+  ConfigureLockstep(lockstep);
+  if (lockstep.bEnabled)
+  {
+    LockstepSession::Connect(mRegistry, lockstep);
+  }
+
   InitSystems();
 }
 
+void Engine::ConfigureThreadPool(ThreadPoolConfig& config)
+{
+}
+
+void Engine::ConfigureSimulation(SimulationConfig& config)
+{
+}
+
+void Engine::ConfigureProfiler(SystemProfilerConfig& config)
+{
+}
+
+void Engine::ConfigureLockstep(LockstepConfig& config)
+{
+}
+
 void Engine::InitSystems()
 {
-  mUpdateSystems.emplace_back(SShape());
+  CoreSystems::ConnectTrackers(mRegistry);
+  CommandQueue::Connect(mRegistry, mThreadPool->GetNumThreads());
+
+  mSystems = new CoreSystems();
+  mSystems->Init(*mThreadPool, CommandQueue::Get(mRegistry));
+
+  mScheduler = new SystemScheduler();
+  mScheduler->SetCommandQueue(&CommandQueue::Get(mRegistry));
+
+  if (mProfilerConfig.bEnabled)
+  {
+    mSystems->SetProfiler(&mProfiler);
+    mScheduler->SetProfiler(&mProfiler);
+  }
 }
 
 void Engine::CleanSystems()
 {
-  for (size_t i; i < mUpdateSystems.size(); i++)
+  if (mProfilerConfig.bEnabled && !mProfilerConfig.CsvPath.empty() && mProfiler.WriteCsv(mProfilerConfig.CsvPath))
+  {
+    Logger::Info("System timings written to {}", mProfilerConfig.CsvPath);
+  }
+  mProfiler.Clear();
+
+  delete mScheduler;
+  mScheduler = nullptr;
+
+  mSystems->Shutdown();
+  delete mSystems;
+  mSystems = nullptr;
+
+  for (size_t i = 0; i < mUpdateSystems.size(); i++)
   {
     mUpdateSystems[i]->Shutdown();
     delete mUpdateSystems[i];
   }
   mUpdateSystems.clear();
+
+  LockstepSession::Disconnect(mRegistry);
+  CommandQueue::Disconnect(mRegistry);
+  CoreSystems::DisconnectTrackers(mRegistry);
 }
 
 void Engine::Draw()
@@ -62,17 +175,98 @@ void Engine::PollEvents()
 
 void Engine::Loop()
 {
-  for (SUpdate* system : mUpdateSystems)
+  auto now = std::chrono::steady_clock::now();
+  f32 deltaTime = mLastFrame.time_since_epoch().count() ? std::chrono::duration<f32>(now - mLastFrame).count() : 0.f;
+  mLastFrame = now;
+
+  mSystems->ResetTimings();
+  if (LockstepSession* lockstep = LockstepSession::Find(mRegistry))
+  {
+    RunLockstep(*lockstep, deltaTime);
+  }
+  else
+  {
+    RunFrame(deltaTime);
+  }
+
+  mProfiler.EndFrame();
+}
+
+void Engine::RunFrame(f32 deltaTime)
+{
+  // Deferred structural changes land between phases, where nothing iterates.
+  CommandQueue& commands = CommandQueue::Get(mRegistry);
+
+  mSystems->Run<ESystemPhase::PreUpdate>(deltaTime);
+  commands.Playback(mRegistry);
+
+  f32 stepTime = mClock.GetStepTime();
+  for (u32 steps = mClock.Advance(deltaTime); steps > 0; steps--)
+  {
+    mSystems->Run<ESystemPhase::FixedUpdate>(stepTime);
+    commands.Playback(mRegistry);
+  }
+
+  mSystems->Run<ESystemPhase::Update>(deltaTime);
+  if (!mUpdateSystems.empty())
+  {
+    mScheduler->Run(*mThreadPool, deltaTime);
+  }
+  commands.Playback(mRegistry);
+  mSystems->Run<ESystemPhase::PostUpdate>(deltaTime);
+  commands.Playback(mRegistry);
+}
+
+void Engine::RunLockstep(LockstepSession& session, f32 deltaTime)
+{
+  CommandQueue& commands = CommandQueue::Get(mRegistry);
+
+  // Frame time only decides how many ticks are due. Every phase runs once
+  // per tick with the fixed step, so the state after a tick only depends on
+  // the state before it and the inputs.
+  f32 stepTime = mClock.GetStepTime();
+  u32 steps = mClock.Advance(deltaTime);
+  u32 step = 0;
+  for (; step < steps && session.IsReady(); step++)
+  {
+    session.BeginTick();
+    mSystems->Run<ESystemPhase::PreUpdate>(stepTime);
+    commands.Playback(mRegistry);
+    mSystems->Run<ESystemPhase::FixedUpdate>(stepTime);
+    commands.Playback(mRegistry);
+    mSystems->Run<ESystemPhase::Update>(stepTime);
+    if (!mUpdateSystems.empty())
+    {
+      mScheduler->Run(*mThreadPool, stepTime);
+    }
+    commands.Playback(mRegistry);
+    mSystems->Run<ESystemPhase::PostUpdate>(stepTime);
+    commands.Playback(mRegistry);
+    session.EndTick(session.ShouldChecksum() ? CoreSnapshot::Checksum(mRegistry) : 0);
+  }
+
+  // Ticks waiting on a peer's input run once it arrives.
+  if (step < steps)
   {
-    system->Update(0.f);
+    mClock.Defer(steps - step);
   }
 }
 
+void Engine::Extract(RenderSnapshot& snapshot)
+{
+  mSystems->Run<ESystemPhase::Extract>(snapshot);
+  mProfiler.GetStats(snapshot.SystemTimings);
+}
+
 void Engine::Clean()
 {
   CHECK_IN();
 
   CleanSystems();
+
+  mThreadPool->Shutdown();
+  delete mThreadPool;
+  mThreadPool = nullptr;
 }
 
 } // namespace tk
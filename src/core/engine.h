@@ -2,6 +2,12 @@
 #define TECK_ENGINE_H
 
 #include "core.h"
+#include "core/dynamic_array.h"
+#include "core/ecs/registry.h"
+#include "core/render_snapshot.h"
+#include "core/simulation_clock.h"
+#include "core/systems/system_pipeline.h"
+#include <chrono>
 #include <vector>
 
 namespace tk
@@ -11,7 +17,7 @@ class Engine
 {
 protected:
   u8 bRunning : 1;
-  static Engine mInstance;
+  static Engine* mInstance;
 
 protected:
   Engine();
@@ -19,21 +25,54 @@ protected:
 public:
   static Engine& Get();
 
+  Registry& GetRegistry();
+  class ThreadPool& GetThreadPool();
+
+  // Registers a system at runtime. It is owned by the engine and runs after the
+  // static Update systems through the scheduler.
+  void AddSystem(class SUpdate* system);
+  const SystemPhaseTimings& GetPhaseTimings() const;
+  // Rolling CPU time of every Update system, core and registered.
+  const SystemProfiler& GetSystemProfiler() const;
+  const SimulationClock& GetSimulationClock() const;
+
+  // Binary snapshot of every entity and the core components, for checkpoints
+  // and rollback. out keeps its memory between saves. Loading replaces the
+  // whole world and must happen between simulation steps.
+  void SaveSnapshot(DynamicArray<u8>& out) const;
+  bool LoadSnapshot(const u8* data, size_t size);
+
 private:
+  Registry mRegistry{};
+  class ThreadPool* mThreadPool{};
+  class CoreSystems* mSystems{};
+  class SystemScheduler* mScheduler{};
   std::vector<class SUpdate*> mUpdateSystems{};
+  SimulationClock mClock{};
+  SystemProfiler mProfiler{};
+  SystemProfilerConfig mProfilerConfig{};
+  std::chrono::steady_clock::time_point mLastFrame{};
 
 private:
   void InitSystems();
   void CleanSystems();
+  void RunFrame(f32 deltaTime);
+  void RunLockstep(class LockstepSession& session, f32 deltaTime);
 
 protected:
   virtual void Init();
+  virtual void ConfigureThreadPool(struct ThreadPoolConfig& config);
+  virtual void ConfigureSimulation(SimulationConfig& config);
+  virtual void ConfigureProfiler(SystemProfilerConfig& config);
+  // Lockstep is off unless enabled here. Peers must start from the same state.
+  virtual void ConfigureLockstep(struct LockstepConfig& config);
 
   virtual void ParseArgs(i32 argc, char** argv);
 
   virtual void PollEvents();
   virtual void Loop();
   virtual void Draw();
+  void Extract(RenderSnapshot& snapshot);
 
   virtual void Clean();
 };
@@ -0,0 +1,23 @@
+#ifndef TKE_SYSTEM_PHASE_H
+#define TKE_SYSTEM_PHASE_H
+
+#include "core/types.h"
+
+namespace tk
+{
+
+// Order in which the engine runs its system phases every frame.
+enum class ESystemPhase : u8
+{
+  PreUpdate = 0,
+  FixedUpdate,
+  Update,
+  PostUpdate,
+  Extract,
+
+  NumPhases
+};
+
+} // namespace tk
+
+#endif // !TKE_SYSTEM_PHASE_H
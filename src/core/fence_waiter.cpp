@@ -0,0 +1,118 @@
+#include "fence_waiter.h"
+#include "core/threads/thread_pool.h"
+
+namespace tk
+{
+
+FenceWaiter::FenceWaiter(const vk::Device& device, ThreadPool* threadPool) : mDevice(device), mThreadPool(threadPool)
+{
+}
+
+FenceWaiter::~FenceWaiter()
+{
+  Stop();
+}
+
+void FenceWaiter::Start()
+{
+  bRunning = true;
+  mThread = std::thread([this]() { Main(); });
+}
+
+void FenceWaiter::Stop()
+{
+  {
+    std::lock_guard lock(mMutex);
+    if (!bRunning)
+    {
+      return;
+    }
+    bRunning = false;
+  }
+  mCondition.notify_all();
+  mThread.join();
+}
+
+bool FenceWaiter::IsSignaled(const vk::Fence& fence) const
+{
+  return mDevice.getFenceStatus(fence) == vk::Result::eSuccess;
+}
+
+void FenceWaiter::Add(const vk::Fence& fence, std::coroutine_handle<> handle)
+{
+  {
+    std::lock_guard lock(mMutex);
+    mWaiters.push_back({fence, handle});
+  }
+  mCondition.notify_one();
+}
+
+void FenceWaiter::Main()
+{
+  DynamicArray<vk::Fence> fences;
+  DynamicArray<std::coroutine_handle<>> ready;
+
+  while (true)
+  {
+    {
+      std::unique_lock lock(mMutex);
+      mCondition.wait(lock, [this]() { return !mWaiters.empty() || !bRunning; });
+
+      // Pending waiters are still resumed on shutdown, the device is idle by then.
+      if (mWaiters.empty())
+      {
+        return;
+      }
+
+      fences.clear();
+      for (const Waiter& waiter : mWaiters)
+      {
+        fences.push_back(waiter.Fence);
+      }
+    }
+
+    // Time out regularly so fences added meanwhile get picked up.
+    vk::Result result = mDevice.waitForFences(fences, vk::False, WaitTimeoutNs);
+    if (result == vk::Result::eTimeout)
+    {
+      continue;
+    }
+
+    {
+      std::lock_guard lock(mMutex);
+      for (size_t i = 0; i < mWaiters.size();)
+      {
+        if (IsSignaled(mWaiters[i].Fence))
+        {
+          ready.push_back(mWaiters[i].Handle);
+          mWaiters[i] = mWaiters.back();
+          mWaiters.pop_back();
+        }
+        else
+        {
+          i++;
+        }
+      }
+    }
+
+    for (std::coroutine_handle<> handle : ready)
+    {
+      Resume(handle);
+    }
+    ready.clear();
+  }
+}
+
+void FenceWaiter::Resume(std::coroutine_handle<> handle)
+{
+  if (mThreadPool && mThreadPool->Running())
+  {
+    mThreadPool->Schedule([handle]() { handle.resume(); });
+  }
+  else
+  {
+    handle.resume();
+  }
+}
+
+} // namespace tk
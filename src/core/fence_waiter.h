@@ -0,0 +1,73 @@
+#ifndef TK_FENCE_WAITER_H
+#define TK_FENCE_WAITER_H
+
+#include "core/dynamic_array.h"
+#include <condition_variable>
+#include <coroutine>
+#include <mutex>
+#include <thread>
+#include <vulkan/vulkan.hpp>
+
+namespace tk
+{
+
+// Vulkan has no fence callbacks, so one thread blocks on all pending fences at
+// once and resumes the coroutines waiting on them, on the pool if there is one.
+class FenceWaiter
+{
+  struct Waiter
+  {
+    vk::Fence Fence;
+    std::coroutine_handle<> Handle;
+  };
+
+  static constexpr u64 WaitTimeoutNs = 1'000'000;
+
+  vk::Device mDevice;
+  class ThreadPool* mThreadPool;
+  DynamicArray<Waiter> mWaiters = {};
+  std::mutex mMutex;
+  std::condition_variable mCondition;
+  std::thread mThread;
+  bool bRunning = false;
+
+public:
+  FenceWaiter(const vk::Device& device, class ThreadPool* threadPool);
+  ~FenceWaiter();
+
+  void Start();
+  void Stop();
+
+  bool IsSignaled(const vk::Fence& fence) const;
+  void Add(const vk::Fence& fence, std::coroutine_handle<> handle);
+
+  auto Await(const vk::Fence& fence)
+  {
+    struct Awaiter
+    {
+      FenceWaiter& mWaiter;
+      vk::Fence mFence;
+
+      bool await_ready() const
+      {
+        return mWaiter.IsSignaled(mFence);
+      }
+      void await_suspend(std::coroutine_handle<> handle)
+      {
+        mWaiter.Add(mFence, handle);
+      }
+      void await_resume() const noexcept
+      {
+      }
+    };
+    return Awaiter{*this, fence};
+  }
+
+private:
+  void Main();
+  void Resume(std::coroutine_handle<> handle);
+};
+
+} // namespace tk
+
+#endif // !TK_FENCE_WAITER_H
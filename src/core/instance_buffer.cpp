@@ -0,0 +1,73 @@
+#include "instance_buffer.h"
+#include "core/render-util.h"
+#include <cstring>
+
+namespace tk
+{
+
+InstanceBuffer::InstanceBuffer(const vk::Device& device, const vk::PhysicalDevice& physicalDevice, u32 capacity)
+    : mDevice(device), mPhysicalDevice(physicalDevice)
+{
+  Allocate(capacity < MinCapacity ? MinCapacity : capacity);
+}
+
+InstanceBuffer::~InstanceBuffer()
+{
+  Free();
+}
+
+void InstanceBuffer::Reserve(u32 count)
+{
+  if (count <= mCapacity)
+  {
+    return;
+  }
+
+  u32 capacity = mCapacity;
+  while (capacity < count)
+  {
+    capacity *= 2;
+  }
+
+  // Mapped memory is write combined, reading it back is slow but growing only
+  // happens while the instance count ramps up.
+  vk::Buffer oldBuffer = mBuffer;
+  vk::DeviceMemory oldMemory = mMemory;
+  RenderInstance* oldData = mData;
+
+  Allocate(capacity);
+  memcpy(mData, oldData, mSize * sizeof(RenderInstance));
+
+  mDevice.unmapMemory(oldMemory);
+  mDevice.destroyBuffer(oldBuffer);
+  mDevice.freeMemory(oldMemory);
+}
+
+void InstanceBuffer::Allocate(u32 capacity)
+{
+  vk::DeviceSize size = capacity * sizeof(RenderInstance);
+  ru::vCreateBuffer(mDevice, mPhysicalDevice, size, vk::BufferUsageFlagBits::eVertexBuffer,
+                    vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent, mBuffer,
+                    mMemory);
+  mData = static_cast<RenderInstance*>(mDevice.mapMemory(mMemory, 0, size, vk::MemoryMapFlags(0)));
+  mCapacity = capacity;
+}
+
+void InstanceBuffer::Free()
+{
+  if (!mBuffer)
+  {
+    return;
+  }
+
+  mDevice.unmapMemory(mMemory);
+  mDevice.destroyBuffer(mBuffer);
+  mDevice.freeMemory(mMemory);
+  mBuffer = nullptr;
+  mMemory = nullptr;
+  mData = nullptr;
+  mCapacity = 0;
+  mSize = 0;
+}
+
+} // namespace tk
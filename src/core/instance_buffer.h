@@ -0,0 +1,81 @@
+#ifndef TK_INSTANCE_BUFFER_H
+#define TK_INSTANCE_BUFFER_H
+
+#include "core/render_snapshot.h"
+#include <vulkan/vulkan.hpp>
+
+namespace tk
+{
+
+// Persistently mapped vertex buffer of RenderInstances. Extract systems write
+// into it directly and the renderer binds it as per-instance vertex input, so
+// instance data is written exactly once on its way from the ECS to the GPU.
+// The Renderer owns a small pool of these and hands one to the game thread per
+// snapshot, only one thread ever touches a buffer at a time.
+class InstanceBuffer
+{
+  static constexpr u32 MinCapacity = 1024;
+
+  vk::Device mDevice;
+  vk::PhysicalDevice mPhysicalDevice;
+  vk::Buffer mBuffer;
+  vk::DeviceMemory mMemory;
+  RenderInstance* mData = nullptr;
+  u32 mCapacity = 0;
+  u32 mSize = 0;
+
+public:
+  InstanceBuffer(const vk::Device& device, const vk::PhysicalDevice& physicalDevice, u32 capacity = MinCapacity);
+  ~InstanceBuffer();
+
+  InstanceBuffer(const InstanceBuffer&) = delete;
+  InstanceBuffer& operator=(const InstanceBuffer&) = delete;
+
+  // Grows the buffer so count instances fit without reallocating mid-pass.
+  void Reserve(u32 count);
+
+  // Sets the size without touching the data, instances written into this
+  // buffer by an earlier snapshot keep their values.
+  void Resize(u32 count)
+  {
+    Reserve(count);
+    mSize = count;
+  }
+
+  void Set(u32 index, const RenderInstance& instance)
+  {
+    mData[index] = instance;
+  }
+
+  void Push(const RenderInstance& instance)
+  {
+    if (mSize == mCapacity)
+    {
+      Reserve(mCapacity * 2);
+    }
+    mData[mSize++] = instance;
+  }
+
+  void Clear()
+  {
+    mSize = 0;
+  }
+
+  u32 Size() const
+  {
+    return mSize;
+  }
+
+  const vk::Buffer& GetBuffer() const
+  {
+    return mBuffer;
+  }
+
+private:
+  void Allocate(u32 capacity);
+  void Free();
+};
+
+} // namespace tk
+
+#endif // !TK_INSTANCE_BUFFER_H
@@ -0,0 +1,213 @@
+#include "lockstep.h"
+#include "core/ecs/snapshot_archive.h"
+#include "core/logger.h"
+#include <algorithm>
+
+namespace tk
+{
+
+LockstepSession::LockstepSession(const LockstepConfig& config) : mConfig(config)
+{
+  mConfig.NumPlayers = std::max(mConfig.NumPlayers, 1u);
+  if (mConfig.LocalPlayer >= mConfig.NumPlayers)
+  {
+    Logger::Error("Lockstep local player {} out of {} players", mConfig.LocalPlayer, mConfig.NumPlayers);
+    mConfig.LocalPlayer = 0;
+  }
+  mConfig.InputDelay = std::min(mConfig.InputDelay, WindowSize - 1);
+
+  mInputs.resize(WindowSize);
+  mChecksums.resize(WindowSize);
+
+  // Nobody could send input for the first ticks, they run without.
+  for (u64 tick = 0; tick < mConfig.InputDelay; tick++)
+  {
+    for (u32 player = 0; player < mConfig.NumPlayers; player++)
+    {
+      StoreInput(tick, player, nullptr, 0);
+    }
+  }
+}
+
+void LockstepSession::SetLocalInput(const void* data, size_t size)
+{
+  mLocalInput.assign(static_cast<const u8*>(data), static_cast<const u8*>(data) + size);
+}
+
+bool LockstepSession::Receive(const u8* data, size_t size)
+{
+  SnapshotReader reader(data, size);
+  MessageHeader header;
+  reader(header);
+  const u8* input = reader.View(header.InputSize);
+  if (!reader.Ok() || header.Magic != Magic || header.Player >= mConfig.NumPlayers ||
+      header.Player == mConfig.LocalPlayer)
+  {
+    Logger::Error("Lockstep message is corrupt");
+    return false;
+  }
+
+  if (!StoreInput(header.InputTick, header.Player, input, header.InputSize))
+  {
+    Logger::Error("Lockstep input of player {} for tick {} is outside the window at tick {}", header.Player,
+                  header.InputTick, mTick);
+    return false;
+  }
+  if (header.ChecksumTick != NoTick)
+  {
+    StoreChecksum(header.ChecksumTick, header.Player, header.Checksum, false);
+  }
+  return true;
+}
+
+void LockstepSession::TakeOutgoing(DynamicArray<DynamicArray<u8>>& out)
+{
+  out.clear();
+  std::swap(out, mOutgoing);
+}
+
+bool LockstepSession::IsReady() const
+{
+  const InputSlot& slot = mInputs[mTick % WindowSize];
+  return slot.Tick == mTick && slot.NumReceived == mConfig.NumPlayers;
+}
+
+void LockstepSession::BeginTick()
+{
+  bInTick = true;
+
+  u64 inputTick = mTick + mConfig.InputDelay;
+  StoreInput(inputTick, mConfig.LocalPlayer, mLocalInput.data(), mLocalInput.size());
+  if (mConfig.NumPlayers > 1)
+  {
+    MessageHeader header{Magic, mConfig.LocalPlayer, inputTick, mLastChecksumTick, mLastChecksum,
+                         (u32)mLocalInput.size()};
+    DynamicArray<u8>& message = mOutgoing.emplace_back();
+    SnapshotWriter writer(message);
+    writer(header);
+    if (!mLocalInput.empty())
+    {
+      writer.Write(mLocalInput.data(), mLocalInput.size());
+    }
+  }
+  mLocalInput.clear();
+}
+
+void LockstepSession::EndTick(u64 checksum)
+{
+  if (ShouldChecksum())
+  {
+    StoreChecksum(mTick, mConfig.LocalPlayer, checksum, true);
+    mLastChecksumTick = mTick;
+    mLastChecksum = checksum;
+  }
+
+  mInputs[mTick % WindowSize].Tick = NoTick;
+  mTick++;
+  bInTick = false;
+}
+
+bool LockstepSession::ShouldChecksum() const
+{
+  return mConfig.ChecksumInterval != 0 && mTick % mConfig.ChecksumInterval == 0;
+}
+
+std::span<const u8> LockstepSession::GetInput(u32 player) const
+{
+  const InputSlot& slot = mInputs[mTick % WindowSize];
+  if (!bInTick || player >= mConfig.NumPlayers || slot.Tick != mTick)
+  {
+    return {};
+  }
+  return slot.Inputs[player];
+}
+
+LockstepSession::InputSlot& LockstepSession::GetInputSlot(u64 tick)
+{
+  InputSlot& slot = mInputs[tick % WindowSize];
+  if (slot.Tick != tick)
+  {
+    slot.Tick = tick;
+    slot.NumReceived = 0;
+    slot.bReceived.assign(mConfig.NumPlayers, false);
+    slot.Inputs.resize(mConfig.NumPlayers);
+    for (DynamicArray<u8>& input : slot.Inputs)
+    {
+      input.clear();
+    }
+  }
+  return slot;
+}
+
+LockstepSession::ChecksumSlot& LockstepSession::GetChecksumSlot(u64 tick)
+{
+  ChecksumSlot& slot = mChecksums[tick % WindowSize];
+  if (slot.Tick != tick)
+  {
+    slot.Tick = tick;
+    slot.bLocal = false;
+    slot.bRemote.assign(mConfig.NumPlayers, false);
+    slot.Remote.resize(mConfig.NumPlayers);
+  }
+  return slot;
+}
+
+bool LockstepSession::StoreInput(u64 tick, u32 player, const u8* data, size_t size)
+{
+  // Late duplicates are harmless, inputs from too far ahead can't be kept.
+  if (tick < mTick)
+  {
+    return true;
+  }
+  if (tick - mTick >= WindowSize)
+  {
+    return false;
+  }
+
+  InputSlot& slot = GetInputSlot(tick);
+  if (!slot.bReceived[player])
+  {
+    slot.bReceived[player] = true;
+    slot.NumReceived++;
+    slot.Inputs[player].assign(data, data + size);
+  }
+  return true;
+}
+
+void LockstepSession::StoreChecksum(u64 tick, u32 player, u64 checksum, bool bLocal)
+{
+  const ChecksumSlot& current = mChecksums[tick % WindowSize];
+  if (tick + WindowSize <= mTick || (current.Tick != NoTick && current.Tick > tick))
+  {
+    return;
+  }
+
+  ChecksumSlot& slot = GetChecksumSlot(tick);
+  if (bLocal)
+  {
+    slot.bLocal = true;
+    slot.Local = checksum;
+  }
+  else
+  {
+    slot.bRemote[player] = true;
+    slot.Remote[player] = checksum;
+  }
+
+  if (!slot.bLocal || IsDesynced())
+  {
+    return;
+  }
+  for (u32 remote = 0; remote < mConfig.NumPlayers; remote++)
+  {
+    if (slot.bRemote[remote] && slot.Remote[remote] != slot.Local)
+    {
+      mDesyncTick = tick;
+      Logger::Error("Lockstep desync at tick {}: player {} has {:x}, local {:x}", tick, remote, slot.Remote[remote],
+                    slot.Local);
+      return;
+    }
+  }
+}
+
+} // namespace tk
@@ -0,0 +1,159 @@
+#ifndef TK_LOCKSTEP_H
+#define TK_LOCKSTEP_H
+
+#include "core/dynamic_array.h"
+#include "core/ecs/registry.h"
+#include "core/types.h"
+#include <span>
+
+namespace tk
+{
+
+struct LockstepConfig
+{
+  bool bEnabled = false;
+  u32 NumPlayers = 1;
+  u32 LocalPlayer = 0;
+  // Ticks between sampling local input and simulating it. Has to cover the
+  // round trip to the slowest peer or the simulation stalls waiting.
+  u32 InputDelay = 3;
+  // Ticks between state checksums, 0 to never compare states.
+  u32 ChecksumInterval = 1;
+};
+
+// Deterministic lockstep: every peer runs the same simulation from the same
+// start state and only exchanges inputs. Tick T runs once the inputs of all
+// players for T are in. Local input set during tick T is scheduled for
+// T + InputDelay and broadcast right away, along with the checksum of the
+// last tick, so desyncs are caught the tick they happen.
+//
+// Inputs are opaque bytes, game systems decode them through GetInput while
+// a tick runs. Moving messages between peers is up to the transport: drain
+// TakeOutgoing, feed what arrives into Receive.
+//
+// Lives in the registry context, only used on the game thread.
+class LockstepSession
+{
+public:
+  // Ticks of input and checksums kept around, peers can't drift further.
+  static constexpr u32 WindowSize = 256;
+  static constexpr u64 NoTick = ~0ull;
+
+private:
+  struct InputSlot
+  {
+    u64 Tick = NoTick;
+    u32 NumReceived = 0;
+    DynamicArray<u8> bReceived = {};
+    DynamicArray<DynamicArray<u8>> Inputs = {};
+  };
+
+  struct ChecksumSlot
+  {
+    u64 Tick = NoTick;
+    bool bLocal = false;
+    u64 Local = 0;
+    DynamicArray<u8> bRemote = {};
+    DynamicArray<u64> Remote = {};
+  };
+
+  struct MessageHeader
+  {
+    u32 Magic = 0;
+    u32 Player = 0;
+    u64 InputTick = 0;
+    u64 ChecksumTick = 0;
+    u64 Checksum = 0;
+    u32 InputSize = 0;
+    u32 Reserved = 0;
+  };
+
+  static constexpr u32 Magic = 0x534c4b54; // "TKLS"
+
+  LockstepConfig mConfig = {};
+  DynamicArray<InputSlot> mInputs = {};
+  DynamicArray<ChecksumSlot> mChecksums = {};
+  DynamicArray<u8> mLocalInput = {};
+  DynamicArray<DynamicArray<u8>> mOutgoing = {};
+  u64 mTick = 0;
+  u64 mLastChecksumTick = NoTick;
+  u64 mLastChecksum = 0;
+  u64 mDesyncTick = NoTick;
+  bool bInTick = false;
+
+public:
+  explicit LockstepSession(const LockstepConfig& config);
+
+  // Input the local player sends with the next tick, kept until then.
+  void SetLocalInput(const void* data, size_t size);
+
+  // Decodes a message from a peer. Returns false for malformed messages and
+  // inputs outside the window.
+  bool Receive(const u8* data, size_t size);
+  // Moves the messages to send to every other peer into out.
+  void TakeOutgoing(DynamicArray<DynamicArray<u8>>& out);
+
+  // True once every player's input for the next tick is in.
+  bool IsReady() const;
+  void BeginTick();
+  // Ends the tick, checksum is the simulation state after it and only used
+  // on ticks that ShouldChecksum.
+  void EndTick(u64 checksum);
+  bool ShouldChecksum() const;
+
+  // Input of player for the running tick, empty if they sent none.
+  std::span<const u8> GetInput(u32 player) const;
+
+  // Next tick to run, or the running one inside BeginTick / EndTick.
+  u64 GetTick() const
+  {
+    return mTick;
+  }
+
+  u32 GetNumPlayers() const
+  {
+    return mConfig.NumPlayers;
+  }
+
+  const LockstepConfig& GetConfig() const
+  {
+    return mConfig;
+  }
+
+  bool IsDesynced() const
+  {
+    return mDesyncTick != NoTick;
+  }
+
+  // First tick whose checksums didn't match, NoTick if none.
+  u64 GetDesyncTick() const
+  {
+    return mDesyncTick;
+  }
+
+  static LockstepSession& Connect(Registry& registry, const LockstepConfig& config)
+  {
+    return registry.ctx().emplace<LockstepSession>(config);
+  }
+
+  static void Disconnect(Registry& registry)
+  {
+    registry.ctx().erase<LockstepSession>();
+  }
+
+  // Null unless the registry runs in lockstep.
+  static LockstepSession* Find(Registry& registry)
+  {
+    return registry.ctx().find<LockstepSession>();
+  }
+
+private:
+  InputSlot& GetInputSlot(u64 tick);
+  ChecksumSlot& GetChecksumSlot(u64 tick);
+  bool StoreInput(u64 tick, u32 player, const u8* data, size_t size);
+  void StoreChecksum(u64 tick, u32 player, u64 checksum, bool bLocal);
+};
+
+} // namespace tk
+
+#endif // !TK_LOCKSTEP_H
@@ -0,0 +1,327 @@
+#include "transform_kernels.h"
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define TK_SIMD_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define TK_TARGET_AVX2
+#else
+#define TK_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace tk::TransformKernels
+{
+
+namespace
+{
+
+// Cephes single precision sin/cos, accurate to a few ulp for |x| < 8192.
+constexpr f32 TwoOverPi = 0.636619772367581343f;
+constexpr f32 HalfPi0 = 1.5703125f;
+constexpr f32 HalfPi1 = 4.837512969970703125e-4f;
+constexpr f32 HalfPi2 = 7.54978995489188216e-8f;
+constexpr f32 Sin0 = -1.9515295891e-4f;
+constexpr f32 Sin1 = 8.3321608736e-3f;
+constexpr f32 Sin2 = -1.6666654611e-1f;
+constexpr f32 Cos0 = 2.443315711809948e-5f;
+constexpr f32 Cos1 = -1.388731625493765e-3f;
+constexpr f32 Cos2 = 4.166664568298827e-2f;
+
+void IntegrateVelocityScalar(f32* positionX, f32* positionY, f32* rotation, const f32* velocityX,
+                             const f32* velocityY, const f32* angularVelocity, u32 begin, u32 end, f32 deltaTime)
+{
+  for (u32 i = begin; i < end; i++)
+  {
+    positionX[i] += velocityX[i] * deltaTime;
+    positionY[i] += velocityY[i] * deltaTime;
+    rotation[i] += angularVelocity[i] * deltaTime;
+  }
+}
+
+void BuildModelMatricesScalar(const f32* positionX, const f32* positionY, const f32* rotation, const f32* scale,
+                              u32 begin, u32 end, Affine2D* outMatrices)
+{
+  for (u32 i = begin; i < end; i++)
+  {
+    // Same approximation as the SIMD lanes, so an entity's matrix doesn't
+    // depend on whether it landed in the tail.
+    f32 sin, cos;
+    TransformKernels::SinCos(rotation[i], sin, cos);
+    sin *= scale[i];
+    cos *= scale[i];
+    outMatrices[i] = {v2(cos, sin), v2(-sin, cos), v2(positionX[i], positionY[i]), v2(0.f)};
+  }
+}
+
+#ifdef TK_SIMD_X86
+
+void SinCos(__m128 x, __m128& outSin, __m128& outCos)
+{
+  __m128i quadrant = _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(TwoOverPi)));
+  __m128 q = _mm_cvtepi32_ps(quadrant);
+  __m128 r = _mm_sub_ps(x, _mm_mul_ps(q, _mm_set1_ps(HalfPi0)));
+  r = _mm_sub_ps(r, _mm_mul_ps(q, _mm_set1_ps(HalfPi1)));
+  r = _mm_sub_ps(r, _mm_mul_ps(q, _mm_set1_ps(HalfPi2)));
+  __m128 r2 = _mm_mul_ps(r, r);
+
+  __m128 s = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(Sin0), r2), _mm_set1_ps(Sin1));
+  s = _mm_add_ps(_mm_mul_ps(s, r2), _mm_set1_ps(Sin2));
+  s = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(s, r2), r), r);
+
+  __m128 c = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(Cos0), r2), _mm_set1_ps(Cos1));
+  c = _mm_add_ps(_mm_mul_ps(c, r2), _mm_set1_ps(Cos2));
+  c = _mm_mul_ps(_mm_mul_ps(c, r2), r2);
+  c = _mm_add_ps(_mm_sub_ps(c, _mm_mul_ps(r2, _mm_set1_ps(0.5f))), _mm_set1_ps(1.f));
+
+  // Odd quadrants swap sin and cos, the sign follows the quadrant.
+  __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(quadrant, _mm_set1_epi32(1)), _mm_set1_epi32(1)));
+  __m128 sinSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(quadrant, _mm_set1_epi32(2)), 30));
+  __m128 cosSign =
+      _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(quadrant, _mm_set1_epi32(1)), _mm_set1_epi32(2)), 30));
+  outSin = _mm_xor_ps(_mm_or_ps(_mm_and_ps(swap, c), _mm_andnot_ps(swap, s)), sinSign);
+  outCos = _mm_xor_ps(_mm_or_ps(_mm_and_ps(swap, s), _mm_andnot_ps(swap, c)), cosSign);
+}
+
+void IntegrateVelocitySSE2(f32* positionX, f32* positionY, f32* rotation, const f32* velocityX, const f32* velocityY,
+                           const f32* angularVelocity, u32 count, f32 deltaTime)
+{
+  __m128 dt = _mm_set1_ps(deltaTime);
+  u32 i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    _mm_storeu_ps(positionX + i,
+                  _mm_add_ps(_mm_loadu_ps(positionX + i), _mm_mul_ps(_mm_loadu_ps(velocityX + i), dt)));
+    _mm_storeu_ps(positionY + i,
+                  _mm_add_ps(_mm_loadu_ps(positionY + i), _mm_mul_ps(_mm_loadu_ps(velocityY + i), dt)));
+    _mm_storeu_ps(rotation + i,
+                  _mm_add_ps(_mm_loadu_ps(rotation + i), _mm_mul_ps(_mm_loadu_ps(angularVelocity + i), dt)));
+  }
+  IntegrateVelocityScalar(positionX, positionY, rotation, velocityX, velocityY, angularVelocity, i, count, deltaTime);
+}
+
+void BuildModelMatricesSSE2(const f32* positionX, const f32* positionY, const f32* rotation, const f32* scale,
+                            u32 count, Affine2D* outMatrices)
+{
+  u32 i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    __m128 sin, cos;
+    SinCos(_mm_loadu_ps(rotation + i), sin, cos);
+    __m128 s = _mm_loadu_ps(scale + i);
+    sin = _mm_mul_ps(sin, s);
+    cos = _mm_mul_ps(cos, s);
+
+    // Rows hold one field of four matrices, transpose to one matrix half each.
+    __m128 r0 = cos, r1 = sin, r2 = _mm_sub_ps(_mm_setzero_ps(), sin), r3 = cos;
+    __m128 t0 = _mm_loadu_ps(positionX + i), t1 = _mm_loadu_ps(positionY + i);
+    __m128 t2 = _mm_setzero_ps(), t3 = _mm_setzero_ps();
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+    _MM_TRANSPOSE4_PS(t0, t1, t2, t3);
+
+    f32* out = reinterpret_cast<f32*>(outMatrices + i);
+    _mm_store_ps(out + 0, r0);
+    _mm_store_ps(out + 4, t0);
+    _mm_store_ps(out + 8, r1);
+    _mm_store_ps(out + 12, t1);
+    _mm_store_ps(out + 16, r2);
+    _mm_store_ps(out + 20, t2);
+    _mm_store_ps(out + 24, r3);
+    _mm_store_ps(out + 28, t3);
+  }
+  BuildModelMatricesScalar(positionX, positionY, rotation, scale, i, count, outMatrices);
+}
+
+TK_TARGET_AVX2 void SinCos(__m256 x, __m256& outSin, __m256& outCos)
+{
+  __m256i quadrant = _mm256_cvtps_epi32(_mm256_mul_ps(x, _mm256_set1_ps(TwoOverPi)));
+  __m256 q = _mm256_cvtepi32_ps(quadrant);
+  // No FMA, every step rounds like the SSE2 and scalar versions so the lanes
+  // and the scalar tail give the same bits.
+  __m256 r = _mm256_sub_ps(x, _mm256_mul_ps(q, _mm256_set1_ps(HalfPi0)));
+  r = _mm256_sub_ps(r, _mm256_mul_ps(q, _mm256_set1_ps(HalfPi1)));
+  r = _mm256_sub_ps(r, _mm256_mul_ps(q, _mm256_set1_ps(HalfPi2)));
+  __m256 r2 = _mm256_mul_ps(r, r);
+
+  __m256 s = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(Sin0), r2), _mm256_set1_ps(Sin1));
+  s = _mm256_add_ps(_mm256_mul_ps(s, r2), _mm256_set1_ps(Sin2));
+  s = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(s, r2), r), r);
+
+  __m256 c = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(Cos0), r2), _mm256_set1_ps(Cos1));
+  c = _mm256_add_ps(_mm256_mul_ps(c, r2), _mm256_set1_ps(Cos2));
+  c = _mm256_mul_ps(_mm256_mul_ps(c, r2), r2);
+  c = _mm256_add_ps(_mm256_sub_ps(c, _mm256_mul_ps(r2, _mm256_set1_ps(0.5f))), _mm256_set1_ps(1.f));
+
+  __m256 swap =
+      _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(quadrant, _mm256_set1_epi32(1)), _mm256_set1_epi32(1)));
+  __m256 sinSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(quadrant, _mm256_set1_epi32(2)), 30));
+  __m256 cosSign = _mm256_castsi256_ps(
+      _mm256_slli_epi32(_mm256_and_si256(_mm256_add_epi32(quadrant, _mm256_set1_epi32(1)), _mm256_set1_epi32(2)), 30));
+  outSin = _mm256_xor_ps(_mm256_blendv_ps(s, c, swap), sinSign);
+  outCos = _mm256_xor_ps(_mm256_blendv_ps(c, s, swap), cosSign);
+}
+
+TK_TARGET_AVX2 void IntegrateVelocityAVX2(f32* positionX, f32* positionY, f32* rotation, const f32* velocityX,
+                                          const f32* velocityY, const f32* angularVelocity, u32 count, f32 deltaTime)
+{
+  __m256 dt = _mm256_set1_ps(deltaTime);
+  u32 i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    // Multiply and add rounded separately like the SSE2 and scalar paths, a
+    // fused multiply-add would make the simulation depend on the CPU.
+    _mm256_storeu_ps(positionX + i,
+                     _mm256_add_ps(_mm256_loadu_ps(positionX + i), _mm256_mul_ps(_mm256_loadu_ps(velocityX + i), dt)));
+    _mm256_storeu_ps(positionY + i,
+                     _mm256_add_ps(_mm256_loadu_ps(positionY + i), _mm256_mul_ps(_mm256_loadu_ps(velocityY + i), dt)));
+    _mm256_storeu_ps(rotation + i, _mm256_add_ps(_mm256_loadu_ps(rotation + i),
+                                                 _mm256_mul_ps(_mm256_loadu_ps(angularVelocity + i), dt)));
+  }
+  IntegrateVelocityScalar(positionX, positionY, rotation, velocityX, velocityY, angularVelocity, i, count, deltaTime);
+}
+
+TK_TARGET_AVX2 void BuildModelMatricesAVX2(const f32* positionX, const f32* positionY, const f32* rotation,
+                                           const f32* scale, u32 count, Affine2D* outMatrices)
+{
+  u32 i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m256 sin, cos;
+    SinCos(_mm256_loadu_ps(rotation + i), sin, cos);
+    __m256 s = _mm256_loadu_ps(scale + i);
+    sin = _mm256_mul_ps(sin, s);
+    cos = _mm256_mul_ps(cos, s);
+
+    // 8x8 transpose, row k holds field k of eight matrices.
+    __m256 zero = _mm256_setzero_ps();
+    __m256 r0 = cos, r1 = sin, r2 = _mm256_sub_ps(zero, sin), r3 = cos;
+    __m256 r4 = _mm256_loadu_ps(positionX + i), r5 = _mm256_loadu_ps(positionY + i);
+
+    __m256 t0 = _mm256_unpacklo_ps(r0, r1);
+    __m256 t1 = _mm256_unpackhi_ps(r0, r1);
+    __m256 t2 = _mm256_unpacklo_ps(r2, r3);
+    __m256 t3 = _mm256_unpackhi_ps(r2, r3);
+    __m256 t4 = _mm256_unpacklo_ps(r4, r5);
+    __m256 t5 = _mm256_unpackhi_ps(r4, r5);
+
+    __m256 u0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 u1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 u2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 u3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 u4 = _mm256_shuffle_ps(t4, zero, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 u5 = _mm256_shuffle_ps(t4, zero, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 u6 = _mm256_shuffle_ps(t5, zero, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 u7 = _mm256_shuffle_ps(t5, zero, _MM_SHUFFLE(3, 2, 3, 2));
+
+    f32* out = reinterpret_cast<f32*>(outMatrices + i);
+    _mm256_store_ps(out + 0, _mm256_permute2f128_ps(u0, u4, 0x20));
+    _mm256_store_ps(out + 8, _mm256_permute2f128_ps(u1, u5, 0x20));
+    _mm256_store_ps(out + 16, _mm256_permute2f128_ps(u2, u6, 0x20));
+    _mm256_store_ps(out + 24, _mm256_permute2f128_ps(u3, u7, 0x20));
+    _mm256_store_ps(out + 32, _mm256_permute2f128_ps(u0, u4, 0x31));
+    _mm256_store_ps(out + 40, _mm256_permute2f128_ps(u1, u5, 0x31));
+    _mm256_store_ps(out + 48, _mm256_permute2f128_ps(u2, u6, 0x31));
+    _mm256_store_ps(out + 56, _mm256_permute2f128_ps(u3, u7, 0x31));
+  }
+  BuildModelMatricesScalar(positionX, positionY, rotation, scale, i, count, outMatrices);
+}
+
+ESimdLevel DetectSimdLevel()
+{
+#ifdef _MSC_VER
+  i32 info[4];
+  __cpuid(info, 0);
+  if (info[0] >= 7)
+  {
+    __cpuidex(info, 7, 0);
+    bool bAVX2 = info[1] & (1 << 5);
+    __cpuid(info, 1);
+    bool bOSXSAVE = info[2] & (1 << 27);
+    if (bAVX2 && bOSXSAVE && (_xgetbv(0) & 0x6) == 0x6)
+    {
+      return ESimdLevel::AVX2;
+    }
+  }
+  return ESimdLevel::SSE2;
+#else
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2") ? ESimdLevel::AVX2 : ESimdLevel::SSE2;
+#endif
+}
+
+#else
+
+ESimdLevel DetectSimdLevel()
+{
+  return ESimdLevel::Scalar;
+}
+
+#endif
+
+const ESimdLevel SimdLevel = DetectSimdLevel();
+
+} // namespace
+
+ESimdLevel GetSimdLevel()
+{
+  return SimdLevel;
+}
+
+void SinCos(f32 angle, f32& outSin, f32& outCos)
+{
+  // The SSE2 SinCos one lane at a time.
+  f32 q = std::nearbyint(angle * TwoOverPi);
+  i32 quadrant = (i32)q;
+  f32 r = angle - q * HalfPi0;
+  r = r - q * HalfPi1;
+  r = r - q * HalfPi2;
+  f32 r2 = r * r;
+
+  f32 s = Sin0 * r2 + Sin1;
+  s = s * r2 + Sin2;
+  s = s * r2 * r + r;
+
+  f32 c = Cos0 * r2 + Cos1;
+  c = c * r2 + Cos2;
+  c = c * r2 * r2;
+  c = c - r2 * 0.5f + 1.f;
+
+  f32 sin = quadrant & 1 ? c : s;
+  f32 cos = quadrant & 1 ? s : c;
+  outSin = quadrant & 2 ? -sin : sin;
+  outCos = (quadrant + 1) & 2 ? -cos : cos;
+}
+
+void IntegrateVelocity(f32* positionX, f32* positionY, f32* rotation, const f32* velocityX, const f32* velocityY,
+                       const f32* angularVelocity, u32 count, f32 deltaTime)
+{
+#ifdef TK_SIMD_X86
+  if (SimdLevel == ESimdLevel::AVX2)
+  {
+    IntegrateVelocityAVX2(positionX, positionY, rotation, velocityX, velocityY, angularVelocity, count, deltaTime);
+    return;
+  }
+  IntegrateVelocitySSE2(positionX, positionY, rotation, velocityX, velocityY, angularVelocity, count, deltaTime);
+#else
+  IntegrateVelocityScalar(positionX, positionY, rotation, velocityX, velocityY, angularVelocity, 0, count, deltaTime);
+#endif
+}
+
+void BuildModelMatrices(const f32* positionX, const f32* positionY, const f32* rotation, const f32* scale, u32 count,
+                        Affine2D* outMatrices)
+{
+#ifdef TK_SIMD_X86
+  if (SimdLevel == ESimdLevel::AVX2)
+  {
+    BuildModelMatricesAVX2(positionX, positionY, rotation, scale, count, outMatrices);
+    return;
+  }
+  BuildModelMatricesSSE2(positionX, positionY, rotation, scale, count, outMatrices);
+#else
+  BuildModelMatricesScalar(positionX, positionY, rotation, scale, 0, count, outMatrices);
+#endif
+}
+
+} // namespace tk::TransformKernels
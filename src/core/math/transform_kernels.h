@@ -0,0 +1,51 @@
+#ifndef TK_TRANSFORM_KERNELS_H
+#define TK_TRANSFORM_KERNELS_H
+
+#include "core/types.h"
+
+namespace tk
+{
+
+// 2D model matrix, column major like glm, padded to 32 bytes so a whole
+// matrix is one AVX store.
+struct alignas(32) Affine2D
+{
+  v2 Column0 = v2(1.f, 0.f);
+  v2 Column1 = v2(0.f, 1.f);
+  v2 Translation = v2(0.f);
+  v2 Padding = v2(0.f);
+};
+
+enum class ESimdLevel : u8
+{
+  Scalar = 0,
+  SSE2,
+  AVX2
+};
+
+// Kernels over structure-of-arrays transform data. The widest instruction set
+// the CPU supports is picked once at startup, x86 without AVX2 runs SSE2 and
+// every other target runs the scalar loops.
+namespace TransformKernels
+{
+
+ESimdLevel GetSimdLevel();
+
+// Cephes sin and cos built from multiplies and adds only, so unlike std::sin
+// and std::cos the result is the same on every platform and standard library.
+// Simulation code uses it, lockstep peers have to agree to the bit.
+void SinCos(f32 angle, f32& outSin, f32& outCos);
+
+// position += linear * dt, rotation += angular * dt. Bit-identical on every
+// SIMD level.
+void IntegrateVelocity(f32* positionX, f32* positionY, f32* rotation, const f32* velocityX, const f32* velocityY,
+                       const f32* angularVelocity, u32 count, f32 deltaTime);
+
+void BuildModelMatrices(const f32* positionX, const f32* positionY, const f32* rotation, const f32* scale, u32 count,
+                        Affine2D* outMatrices);
+
+} // namespace TransformKernels
+
+} // namespace tk
+
+#endif // !TK_TRANSFORM_KERNELS_H
@@ -0,0 +1,188 @@
+#include "memory_pool.h"
+#include <bit>
+#include <cstdint>
+#include <new>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+namespace tk
+{
+
+static constexpr size_t PageSize = 4096;
+static constexpr size_t HugePageSize = 2 * 1024 * 1024;
+
+MemoryPool::MemoryPool(const MemoryPoolConfig& config) : mConfig(config)
+{
+  size_t granularity = mConfig.bHugePages ? HugePageSize : PageSize;
+  mConfig.ChunkSize = (mConfig.ChunkSize + granularity - 1) / granularity * granularity;
+}
+
+MemoryPool::~MemoryPool()
+{
+  Release();
+}
+
+u32 MemoryPool::GetClass(size_t size, size_t& outClassSize)
+{
+  if (size <= 4 * MinBlockSize)
+  {
+    outClassSize = (size + MinBlockSize - 1) / MinBlockSize * MinBlockSize;
+    return (u32)(outClassSize / MinBlockSize) - 1;
+  }
+
+  // 2^p < size <= 2^(p+1), split into four steps of 2^(p-2).
+  u32 p = (u32)std::bit_width(size - 1) - 1;
+  size_t step = (size_t)1 << (p - 2);
+  size_t k = (size + step - 1) / step;
+  outClassSize = k * step;
+  return 4 + (p - 8) * 4 + (u32)(k - 5);
+}
+
+void* MemoryPool::Allocate(size_t size, size_t alignment)
+{
+  size = size ? size : 1;
+  if (size > GetLargeThreshold() || alignment > BlockAlignment)
+  {
+    Region region = Map(size);
+    mLarge.push_back(region);
+    mUsed += region.Size;
+    return region.Data;
+  }
+
+  size_t classSize = 0;
+  u32 sizeClass = GetClass(size, classSize);
+  mUsed += classSize;
+  if (FreeBlock* block = mFree[sizeClass])
+  {
+    mFree[sizeClass] = block->Next;
+    return block;
+  }
+
+  // Class sizes are multiples of BlockAlignment up to the large threshold, so
+  // the cursor stays aligned.
+  if ((size_t)(mEnd - mCursor) < classSize)
+  {
+    Region chunk = Map(mConfig.ChunkSize);
+    mChunks.push_back(chunk);
+    mCursor = chunk.Data;
+    mEnd = chunk.Data + chunk.Size;
+  }
+  void* data = mCursor;
+  mCursor += classSize;
+  return data;
+}
+
+void MemoryPool::Deallocate(void* data, size_t size, size_t alignment)
+{
+  if (!data)
+  {
+    return;
+  }
+
+  size = size ? size : 1;
+  if (size > GetLargeThreshold() || alignment > BlockAlignment)
+  {
+    for (size_t i = 0; i < mLarge.size(); i++)
+    {
+      if (mLarge[i].Data == data)
+      {
+        mUsed -= mLarge[i].Size;
+        mReserved -= mLarge[i].Size;
+        Unmap(mLarge[i]);
+        mLarge[i] = mLarge.back();
+        mLarge.pop_back();
+        return;
+      }
+    }
+    return;
+  }
+
+  size_t classSize = 0;
+  u32 sizeClass = GetClass(size, classSize);
+  mUsed -= classSize;
+  FreeBlock* block = static_cast<FreeBlock*>(data);
+  block->Next = mFree[sizeClass];
+  mFree[sizeClass] = block;
+}
+
+void MemoryPool::Release()
+{
+  for (const Region& region : mChunks)
+  {
+    Unmap(region);
+  }
+  for (const Region& region : mLarge)
+  {
+    Unmap(region);
+  }
+  mChunks.clear();
+  mLarge.clear();
+  for (FreeBlock*& block : mFree)
+  {
+    block = nullptr;
+  }
+  mCursor = nullptr;
+  mEnd = nullptr;
+  mUsed = 0;
+  mReserved = 0;
+}
+
+MemoryPool::Region MemoryPool::Map(size_t size)
+{
+  size_t granularity = mConfig.bHugePages && size >= HugePageSize ? HugePageSize : PageSize;
+  size = (size + granularity - 1) / granularity * granularity;
+
+#ifdef _WIN32
+  void* data = VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+  if (!data)
+  {
+    throw std::bad_alloc();
+  }
+#else
+  // Huge pages only back 2MB aligned ranges, so map one more and trim.
+  size_t slack = granularity == HugePageSize ? HugePageSize : 0;
+  void* mapping = mmap(nullptr, size + slack, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (mapping == MAP_FAILED)
+  {
+    throw std::bad_alloc();
+  }
+
+  u8* data = static_cast<u8*>(mapping);
+  if (slack)
+  {
+    uintptr_t base = (uintptr_t)mapping;
+    u8* aligned = reinterpret_cast<u8*>((base + HugePageSize - 1) & ~(uintptr_t)(HugePageSize - 1));
+    if (aligned != data)
+    {
+      munmap(data, aligned - data);
+    }
+    size_t tail = slack - (aligned - data);
+    if (tail)
+    {
+      munmap(aligned + size, tail);
+    }
+    data = aligned;
+#ifdef MADV_HUGEPAGE
+    madvise(data, size, MADV_HUGEPAGE);
+#endif
+  }
+#endif
+
+  mReserved += size;
+  return {static_cast<u8*>(data), size};
+}
+
+void MemoryPool::Unmap(const Region& region)
+{
+#ifdef _WIN32
+  VirtualFree(region.Data, 0, MEM_RELEASE);
+#else
+  munmap(region.Data, region.Size);
+#endif
+}
+
+} // namespace tk
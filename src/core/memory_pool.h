@@ -0,0 +1,97 @@
+#ifndef TK_MEMORY_POOL_H
+#define TK_MEMORY_POOL_H
+
+#include "core/dynamic_array.h"
+#include "types.h"
+#include <cstddef>
+
+namespace tk
+{
+
+struct MemoryPoolConfig
+{
+  // Granularity memory is reserved from the system with.
+  size_t ChunkSize = 4 * 1024 * 1024;
+  // Ask for transparent huge pages on the chunks. Only Linux honours it,
+  // elsewhere the chunks use normal pages.
+  bool bHugePages = false;
+};
+
+// General purpose allocator for one owner's data, like the storages of a
+// world's registry. Small and medium blocks are carved out of large chunks
+// and recycled through size class free lists. Classes are multiples of
+// MinBlockSize, four per power of two above 256 bytes, so entt's component
+// pages waste at most a quarter. Blocks over a quarter chunk, or aligned
+// beyond BlockAlignment, are mapped on their own and unmapped when freed.
+//
+// Release, and the destructor, give every chunk back at once no matter what
+// is still allocated, so tearing the owner down costs a handful of unmaps.
+// Not thread-safe.
+class MemoryPool
+{
+public:
+  static constexpr size_t MinBlockSize = 64;
+  static constexpr size_t BlockAlignment = 64;
+
+private:
+  struct Region
+  {
+    u8* Data = nullptr;
+    size_t Size = 0;
+  };
+
+  struct FreeBlock
+  {
+    FreeBlock* Next;
+  };
+
+  static constexpr u32 NumClasses = 4 + 4 * 56;
+
+  MemoryPoolConfig mConfig = {};
+  DynamicArray<Region> mChunks = {};
+  DynamicArray<Region> mLarge = {};
+  FreeBlock* mFree[NumClasses] = {};
+  u8* mCursor = nullptr;
+  u8* mEnd = nullptr;
+  size_t mUsed = 0;
+  size_t mReserved = 0;
+
+public:
+  explicit MemoryPool(const MemoryPoolConfig& config = {});
+  ~MemoryPool();
+
+  MemoryPool(const MemoryPool&) = delete;
+  MemoryPool& operator=(const MemoryPool&) = delete;
+
+  void* Allocate(size_t size, size_t alignment);
+  void Deallocate(void* data, size_t size, size_t alignment);
+
+  // Frees everything at once. Memory handed out before is gone.
+  void Release();
+
+  // Bytes in live blocks, rounded up to their size class.
+  size_t GetUsed() const
+  {
+    return mUsed;
+  }
+
+  // Bytes taken from the system.
+  size_t GetReserved() const
+  {
+    return mReserved;
+  }
+
+private:
+  static u32 GetClass(size_t size, size_t& outClassSize);
+  size_t GetLargeThreshold() const
+  {
+    return mConfig.ChunkSize / 4;
+  }
+
+  Region Map(size_t size);
+  static void Unmap(const Region& region);
+};
+
+} // namespace tk
+
+#endif // !TK_MEMORY_POOL_H
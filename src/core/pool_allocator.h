@@ -0,0 +1,62 @@
+#ifndef TK_POOL_ALLOCATOR_H
+#define TK_POOL_ALLOCATOR_H
+
+#include "core/memory_pool.h"
+#include <memory>
+
+namespace tk
+{
+
+// Allocator over a MemoryPool, or the global heap when it has none.
+// Containers copy the pool along with the allocator, so the pool has to
+// outlive them.
+template <typename T> class PoolAllocator
+{
+  template <typename U> friend class PoolAllocator;
+
+  MemoryPool* mPool = nullptr;
+
+public:
+  using value_type = T;
+
+  PoolAllocator() = default;
+  explicit PoolAllocator(MemoryPool* pool) : mPool(pool)
+  {
+  }
+  template <typename U> PoolAllocator(const PoolAllocator<U>& other) : mPool(other.mPool)
+  {
+  }
+
+  T* allocate(size_t count)
+  {
+    if (!mPool)
+    {
+      return std::allocator<T>().allocate(count);
+    }
+    return static_cast<T*>(mPool->Allocate(count * sizeof(T), alignof(T)));
+  }
+
+  void deallocate(T* data, size_t count)
+  {
+    if (!mPool)
+    {
+      std::allocator<T>().deallocate(data, count);
+      return;
+    }
+    mPool->Deallocate(data, count * sizeof(T), alignof(T));
+  }
+
+  MemoryPool* GetPool() const
+  {
+    return mPool;
+  }
+
+  template <typename U> bool operator==(const PoolAllocator<U>& other) const
+  {
+    return mPool == other.mPool;
+  }
+};
+
+} // namespace tk
+
+#endif // !TK_POOL_ALLOCATOR_H
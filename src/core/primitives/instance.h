@@ -0,0 +1,71 @@
+#ifndef TECH_INSTANCE_H
+#define TECH_INSTANCE_H
+
+#include "../render_snapshot.h"
+#include <vulkan/vulkan.hpp>
+
+namespace tk
+{
+
+// Per-instance vertex input, read straight from an InstanceBuffer.
+struct Instance
+{
+  static constexpr u32 Binding = 1;
+
+  static vk::VertexInputBindingDescription getBindingDescription()
+  {
+    vk::VertexInputBindingDescription bindingDescription = {};
+    bindingDescription.binding = Binding;
+    bindingDescription.stride = sizeof(RenderInstance);
+    bindingDescription.inputRate = vk::VertexInputRate::eInstance;
+
+    return bindingDescription;
+  }
+
+  static std::array<vk::VertexInputAttributeDescription, 6> getAttributeDescriptions()
+  {
+    std::array<vk::VertexInputAttributeDescription, 6> attributeDescriptions = {};
+
+    // Position
+    attributeDescriptions[0].binding = Binding;
+    attributeDescriptions[0].location = 2;
+    attributeDescriptions[0].format = vk::Format::eR32G32Sfloat;
+    attributeDescriptions[0].offset = offsetof(RenderInstance, Position);
+
+    // Rotation
+    attributeDescriptions[1].binding = Binding;
+    attributeDescriptions[1].location = 3;
+    attributeDescriptions[1].format = vk::Format::eR32Sfloat;
+    attributeDescriptions[1].offset = offsetof(RenderInstance, Rotation);
+
+    // Scale
+    attributeDescriptions[2].binding = Binding;
+    attributeDescriptions[2].location = 4;
+    attributeDescriptions[2].format = vk::Format::eR32Sfloat;
+    attributeDescriptions[2].offset = offsetof(RenderInstance, Scale);
+
+    // Previous position
+    attributeDescriptions[3].binding = Binding;
+    attributeDescriptions[3].location = 5;
+    attributeDescriptions[3].format = vk::Format::eR32G32Sfloat;
+    attributeDescriptions[3].offset = offsetof(RenderInstance, PrevPosition);
+
+    // Previous rotation
+    attributeDescriptions[4].binding = Binding;
+    attributeDescriptions[4].location = 6;
+    attributeDescriptions[4].format = vk::Format::eR32Sfloat;
+    attributeDescriptions[4].offset = offsetof(RenderInstance, PrevRotation);
+
+    // Previous scale
+    attributeDescriptions[5].binding = Binding;
+    attributeDescriptions[5].location = 7;
+    attributeDescriptions[5].format = vk::Format::eR32Sfloat;
+    attributeDescriptions[5].offset = offsetof(RenderInstance, PrevScale);
+
+    return attributeDescriptions;
+  }
+};
+
+} // namespace tk
+
+#endif // TECH_INSTANCE_H
@@ -3,6 +3,7 @@
 
 #include "../types.h"
 #include <glm/glm.hpp>
+#include <glm/gtc/constants.hpp>
 #include <vulkan/vulkan.hpp>
 
 namespace tk
@@ -42,12 +43,47 @@ struct Vertex
   }
 };
 
-const std::vector<Vertex> Vertices = {{{-0.5f, -0.5f}, {1.0f, 0.0f, 0.0f}},
-                                      {{0.5f, -0.5f}, {0.0f, 1.0f, 0.0f}},
-                                      {{0.5f, 0.5f}, {0.0f, 0.0f, 1.0f}},
-                                      {{-0.5f, 0.5f}, {1.0f, 1.0f, 1.0f}}};
+// Index range of one shape's line strip in Vertices/Indices.
+struct ShapeMesh
+{
+  u32 FirstIndex;
+  u32 IndexCount;
+  i32 VertexOffset;
+};
+
+constexpr u32 CircleSegments = 24;
+
+const std::vector<Vertex> Vertices = []() {
+  std::vector<Vertex> vertices = {// Square
+                                  {{-0.5f, -0.5f}, {1.0f, 0.0f, 0.0f}},
+                                  {{0.5f, -0.5f}, {0.0f, 1.0f, 0.0f}},
+                                  {{0.5f, 0.5f}, {0.0f, 0.0f, 1.0f}},
+                                  {{-0.5f, 0.5f}, {1.0f, 1.0f, 1.0f}},
+                                  // Triangle
+                                  {{0.0f, 0.5f}, {1.0f, 0.0f, 0.0f}},
+                                  {{-0.433f, -0.25f}, {0.0f, 1.0f, 0.0f}},
+                                  {{0.433f, -0.25f}, {0.0f, 0.0f, 1.0f}}};
+  // Circle
+  for (u32 i = 0; i < CircleSegments; i++)
+  {
+    f32 angle = glm::two_pi<f32>() * i / CircleSegments;
+    vertices.push_back({{0.5f * glm::cos(angle), 0.5f * glm::sin(angle)}, {1.0f, 1.0f, 1.0f}});
+  }
+  return vertices;
+}();
+
+const std::vector<u16> Indices = []() {
+  std::vector<u16> indices = {0, 1, 2, 3, 0, 0, 1, 2, 0};
+  for (u16 i = 0; i < CircleSegments; i++)
+  {
+    indices.push_back(i);
+  }
+  indices.push_back(0);
+  return indices;
+}();
 
-const std::vector<u16> Indices = {0, 1, 2, 3, 0};
+// Indexed by EShape.
+constexpr ShapeMesh ShapeMeshes[] = {{0, 5, 0}, {5, 4, 4}, {9, CircleSegments + 1, 7}};
 
 } // namespace tk
 
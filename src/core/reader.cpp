@@ -5,18 +5,13 @@
 namespace tk
 {
 
-std::vector<char> Reader::ReadShader(const std::string &filename)
+std::vector<char> Reader::ReadFile(const std::string &path)
 {
-#ifdef _WIN32
-  std::string shaderAddress = "../rec/shaders/" + filename + ".spv";
-#else
-  std::string shaderAddress = "rec/shaders/" + filename + ".spv";
-#endif
-  std::ifstream file(shaderAddress, std::ios::ate | std::ios::binary);
+  std::ifstream file(path, std::ios::ate | std::ios::binary);
 
   if (!file.is_open())
   {
-    Logger::Error("Failed to open {}", filename);
+    Logger::Error("Failed to open {}", path);
     throw std::runtime_error("");
   }
 
@@ -31,4 +26,29 @@ std::vector<char> Reader::ReadShader(const std::string &filename)
   return buffer;
 }
 
+std::vector<char> Reader::ReadShader(const std::string &filename)
+{
+  return ReadFile(GetShaderPath(filename));
+}
+
+Task<std::vector<char>> Reader::ReadFileAsync(ThreadPool &pool, std::string path)
+{
+  co_await ScheduleOn(pool);
+  co_return ReadFile(path);
+}
+
+Task<std::vector<char>> Reader::ReadShaderAsync(ThreadPool &pool, std::string filename)
+{
+  return ReadFileAsync(pool, GetShaderPath(filename));
+}
+
+std::string Reader::GetShaderPath(const std::string &filename)
+{
+#ifdef _WIN32
+  return "../rec/shaders/" + filename + ".spv";
+#else
+  return "rec/shaders/" + filename + ".spv";
+#endif
+}
+
 } // namespace tk
@@ -1,6 +1,7 @@
 #ifndef TECH_READER_H
 #define TECH_READER_H
 
+#include "core/threads/task.h"
 #include <string>
 #include <vector>
 
@@ -10,7 +11,15 @@ namespace tk
 class Reader
 {
 public:
+  static std::vector<char> ReadFile(const std::string &path);
   static std::vector<char> ReadShader(const std::string &filename);
+
+  // The read itself runs on a pool worker, the awaiting coroutine resumes there.
+  static Task<std::vector<char>> ReadFileAsync(ThreadPool &pool, std::string path);
+  static Task<std::vector<char>> ReadShaderAsync(ThreadPool &pool, std::string filename);
+
+private:
+  static std::string GetShaderPath(const std::string &filename);
 };
 
 } // namespace tk
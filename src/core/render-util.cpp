@@ -1,6 +1,5 @@
 #include "render-util.h"
 #include "logger.h"
-#include "reader.h"
 #include "renderer.h"
 #include "window.h"
 #include <map>
@@ -206,9 +205,12 @@ vk::Extent2D vChooseSwapExtent(const Renderer& renderer, const vk::SurfaceCapabi
   }
 }
 
-vk::ShaderModule CreateShaderModule(const vk::Device& device, const std::string& shaderName)
+vk::ShaderModule CreateShaderModule(const vk::Device& device, const std::vector<char>& code, const std::string& shaderName)
 {
-  std::vector<char> code = Reader::ReadShader(shaderName);
+  if (code.empty())
+  {
+    throw std::runtime_error("Failed to read shader: " + shaderName);
+  }
 
   vk::ShaderModuleCreateInfo createInfo{};
   createInfo.setCodeSize(code.size());
@@ -245,37 +247,6 @@ void vCreateBuffer(const vk::Device& device, const vk::PhysicalDevice& physicalD
   device.bindBufferMemory(buffer, bufferMemory, 0);
 }
 
-void vCopyBuffer(const vk::Device& device, const vk::CommandPool& commandPool, const vk::Queue& graphicsQueue,
-                 const vk::Buffer& srcBuffer, const vk::Buffer& dstBuffer, vk::DeviceSize size)
-{
-  vk::CommandBufferAllocateInfo allocateInfo{};
-  allocateInfo.setLevel(vk::CommandBufferLevel::ePrimary);
-  allocateInfo.setCommandPool(commandPool);
-  allocateInfo.setCommandBufferCount(1);
-
-  vk::CommandBuffer commandBuffer = device.allocateCommandBuffers(allocateInfo)[0];
-
-  vk::CommandBufferBeginInfo beginInfo{};
-  beginInfo.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
-
-  commandBuffer.begin(beginInfo);
-
-  vk::BufferCopy copyRegion{};
-  copyRegion.setSrcOffset(0).setDstOffset(0).setSize(size);
-  commandBuffer.copyBuffer(srcBuffer, dstBuffer, copyRegion);
-
-  commandBuffer.end();
-
-  vk::SubmitInfo submitInfo{};
-  submitInfo.setCommandBufferCount(1);
-  submitInfo.setPCommandBuffers(&commandBuffer);
-
-  graphicsQueue.submit(submitInfo, nullptr);
-  graphicsQueue.waitIdle();
-
-  device.freeCommandBuffers(commandPool, commandBuffer);
-}
-
 u32 vFindMemoryType(const vk::PhysicalDevice& physicalDevice, u32 typeFilter, vk::MemoryPropertyFlags properties)
 {
   vk::PhysicalDeviceMemoryProperties memProperties = physicalDevice.getMemoryProperties();
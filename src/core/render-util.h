@@ -50,7 +50,7 @@ vk::SurfaceFormatKHR vChooseSwapSurfaceFormat(const std::vector<vk::SurfaceForma
 vk::PresentModeKHR vChooseSwapPresentMode(const std::vector<vk::PresentModeKHR>& availablePresentModes);
 vk::Extent2D vChooseSwapExtent(const Renderer& renderer, const vk::SurfaceCapabilitiesKHR& capabilities);
 
-vk::ShaderModule CreateShaderModule(const vk::Device& device, const std::string& shaderName);
+vk::ShaderModule CreateShaderModule(const vk::Device& device, const std::vector<char>& code, const std::string& shaderName);
 
 u32 vFindMemoryType(const vk::PhysicalDevice& physicalDevice, u32 typeFilter, vk::MemoryPropertyFlags properties);
 
@@ -58,9 +58,6 @@ void vCreateBuffer(const vk::Device& device, const vk::PhysicalDevice& physicalD
                    vk::BufferUsageFlags usage, vk::MemoryPropertyFlags properties, vk::Buffer& buffer,
                    vk::DeviceMemory& bufferMemory);
 
-void vCopyBuffer(const vk::Device& device, const vk::CommandPool& commandPool, const vk::Queue& graphicsQueue,
-                 const vk::Buffer& srcBuffer, const vk::Buffer& dstBuffer, vk::DeviceSize size);
-
 void CopyDataAtOffset(void* dest, size_t offset, const void* src, size_t size);
 
 } // namespace tk::ru
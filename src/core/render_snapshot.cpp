@@ -0,0 +1,16 @@
+#include "render_snapshot.h"
+#include "imgui.h"
+
+namespace tk
+{
+
+void RenderUi::Clear()
+{
+  for (ImDrawList* list : DrawLists)
+  {
+    IM_DELETE(list);
+  }
+  DrawLists.clear();
+}
+
+} // namespace tk
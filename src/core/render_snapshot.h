@@ -0,0 +1,81 @@
+#ifndef TK_RENDER_SNAPSHOT_H
+#define TK_RENDER_SNAPSHOT_H
+
+#include "core/dynamic_array.h"
+#include "core/enums/e_shape.h"
+#include "core/systems/system_profiler.h"
+#include "core/types.h"
+#include <array>
+
+struct ImDrawList;
+
+namespace tk
+{
+
+// Current and previous simulation state. The vertex shader interpolates, so an
+// instance only has to be rewritten when the simulation changes it.
+struct RenderInstance
+{
+  v2 Position = v2(0.f);
+  f32 Rotation = 0.f;
+  f32 Scale = 0.f;
+  v2 PrevPosition = v2(0.f);
+  f32 PrevRotation = 0.f;
+  f32 PrevScale = 0.f;
+  EShape Shape = EShape::Circle;
+};
+
+struct RenderInstanceRange
+{
+  u32 First = 0;
+  u32 Count = 0;
+};
+
+struct RenderCamera
+{
+  v3 Eye = v3(2.f, 2.f, 2.f);
+  v3 Target = v3(0.f, 0.f, 0.f);
+  f32 Fov = 45.f;
+};
+
+// ImGui's draw lists of one frame, cloned on the game thread after
+// ImGui::Render so the render thread never touches the ImGui context.
+struct RenderUi
+{
+  DynamicArray<ImDrawList*> DrawLists = {};
+  v2 DisplayPos = v2(0.f);
+  v2 DisplaySize = v2(0.f);
+  v2 FramebufferScale = v2(1.f);
+
+  RenderUi() = default;
+  RenderUi(const RenderUi&) = delete;
+  RenderUi& operator=(const RenderUi&) = delete;
+  ~RenderUi()
+  {
+    Clear();
+  }
+
+  void Clear();
+};
+
+// Immutable copy of everything the render thread needs for one frame. Written
+// by the game thread, read by the render thread, never shared between both.
+struct RenderSnapshot
+{
+  u64 Frame = 0;
+  // Interpolation factor between the previous and current instance state.
+  f32 Alpha = 0.f;
+  RenderCamera Camera = {};
+  // GPU visible instance data, borrowed from the renderer for this snapshot.
+  // Null when nothing renders, e.g. on the server.
+  class InstanceBuffer* Instances = nullptr;
+  // Instances of each shape are contiguous and drawn with one instanced draw.
+  std::array<RenderInstanceRange, (u32)EShape::NumShapes> ShapeRanges = {};
+  // Copied from the engine's profiler for the debug UI.
+  DynamicArray<SystemTimingStats> SystemTimings = {};
+  RenderUi Ui = {};
+};
+
+} // namespace tk
+
+#endif // !TK_RENDER_SNAPSHOT_H
@@ -13,7 +13,9 @@
 
 #include "core.h"
 #include "dynamic_array.h"
+#include "instance_buffer.h"
 #include "logger.h"
+#include "reader.h"
 #include "render-util.h"
 #include "window.h"
 
@@ -26,6 +28,7 @@
 #include "backends/imgui_impl_glfw.h"
 #include "backends/imgui_impl_vulkan.h"
 #include "imgui.h"
+#include "primitives/instance.h"
 #include "primitives/vertex.h"
 
 namespace tk
@@ -50,26 +53,38 @@ const Window& Renderer::GetWindow() const
   return *mWindow;
 }
 
-void Renderer::Init(Window* window)
+void Renderer::Init(Window* window, ThreadPool* threadPool)
 {
   CHECK_IN();
 
   mWindow = window;
+  mThreadPool = threadPool;
 
   vCreateInstance();
   vSetupDebugMessenger();
   vCreateSurface();
   ru::vPickPhysicalDevice(mInstance, mPhysicalDevice);
   vCreateLogicalDevice();
+
+  mFenceWaiter = new FenceWaiter(mDevice, mThreadPool);
+  mFenceWaiter->Start();
+
+  // The shaders are read on the pool while the swapchain is set up.
+  std::vector<char> vertCode, fragCode;
+  JobHandle vertRead = Spawn(*mThreadPool, vLoadShader("base.vert", vertCode));
+  JobHandle fragRead = Spawn(*mThreadPool, vLoadShader("base.frag", fragCode));
+
   vCreateSwapchain();
   vCreateImageViews();
   vCreateRenderPass();
   vCreateDescriptorSetLayout();
-  vCreateGraphicsPipeline();
+  mThreadPool->Wait(vertRead);
+  mThreadPool->Wait(fragRead);
+  vCreateGraphicsPipeline(vertCode, fragCode);
   vCreateFrameBuffers();
   vCreateCommandPool();
-  vCreateVertexBuffer();
-  vCreateIndexBuffer();
+  SyncWait(*mThreadPool, vCreateGeometryBuffers());
+  vCreateInstanceBuffers();
   vCreateUniformBuffers();
   vCreateDescriptorPool();
   vCreateDescriptorSets();
@@ -78,7 +93,7 @@ void Renderer::Init(Window* window)
 
   for (u32 i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
   {
-    UpdateCamera(i);
+    UpdateCamera(i, RenderCamera{});
   }
 
   ImGuiInit();
@@ -381,10 +396,15 @@ void Renderer::vCreateImageViews()
   }
 }
 
-void Renderer::vCreateGraphicsPipeline()
+Task<void> Renderer::vLoadShader(std::string name, std::vector<char>& outCode)
+{
+  outCode = co_await Reader::ReadShaderAsync(*mThreadPool, std::move(name));
+}
+
+void Renderer::vCreateGraphicsPipeline(const std::vector<char>& vertCode, const std::vector<char>& fragCode)
 {
-  vk::ShaderModule vertModule = ru::CreateShaderModule(mDevice, "base.vert");
-  vk::ShaderModule fragModule = ru::CreateShaderModule(mDevice, "base.frag");
+  vk::ShaderModule vertModule = ru::CreateShaderModule(mDevice, vertCode, "base.vert");
+  vk::ShaderModule fragModule = ru::CreateShaderModule(mDevice, fragCode, "base.frag");
 
   vk::PipelineShaderStageCreateInfo vertShaderStageInfo{};
   vertShaderStageInfo.setStage(vk::ShaderStageFlagBits::eVertex);
@@ -403,10 +423,16 @@ void Renderer::vCreateGraphicsPipeline()
 
   vk::PipelineVertexInputStateCreateInfo vertexInputInfo{};
 
-  auto bindingDescription = Vertex::getBindingDescription();
-  auto attributeDescriptions = Vertex::getAttributeDescriptions();
+  std::array<vk::VertexInputBindingDescription, 2> bindingDescriptions = {Vertex::getBindingDescription(),
+                                                                         Instance::getBindingDescription()};
 
-  vertexInputInfo.setVertexBindingDescriptions(bindingDescription);
+  auto vertexAttributes = Vertex::getAttributeDescriptions();
+  auto instanceAttributes = Instance::getAttributeDescriptions();
+  std::vector<vk::VertexInputAttributeDescription> attributeDescriptions(vertexAttributes.begin(),
+                                                                          vertexAttributes.end());
+  attributeDescriptions.insert(attributeDescriptions.end(), instanceAttributes.begin(), instanceAttributes.end());
+
+  vertexInputInfo.setVertexBindingDescriptions(bindingDescriptions);
   vertexInputInfo.setVertexAttributeDescriptions(attributeDescriptions);
 
   vk::PipelineInputAssemblyStateCreateInfo inputAssembly{};
@@ -478,7 +504,8 @@ void Renderer::vCreateGraphicsPipeline()
 
   vk::PipelineLayoutCreateInfo pipelineLayoutInfo{};
   pipelineLayoutInfo.setSetLayouts(mDescriptorSetLayout);
-  pipelineLayoutInfo.setPushConstantRanges(nullptr);
+  vk::PushConstantRange pushConstantRange(vk::ShaderStageFlagBits::eVertex, 0, sizeof(f32));
+  pipelineLayoutInfo.setPushConstantRanges(pushConstantRange);
 
   mPipelineLayout = mDevice.createPipelineLayout(pipelineLayoutInfo);
   if (!mPipelineLayout)
@@ -598,56 +625,112 @@ void Renderer::vCreateCommandPool()
       .setQueueFamilyIndex(queueFamilyIndices.graphicsFamily.value());
 
   mCommandPool = mDevice.createCommandPool(poolInfo);
+
+  poolInfo.setFlags(vk::CommandPoolCreateFlagBits::eTransient);
+  mUploadCommandPool = mDevice.createCommandPool(poolInfo);
 }
 
-void Renderer::vCreateVertexBuffer()
+Task<void> Renderer::CopyBufferAsync(vk::Buffer srcBuffer, vk::Buffer dstBuffer, vk::DeviceSize size)
 {
-  vk::DeviceSize bufferSize = sizeof(Vertices[0]) * Vertices.size();
+  vk::CommandBuffer commandBuffer;
+  {
+    std::lock_guard lock(mUploadMutex);
 
-  vk::Buffer stagingBuffer;
-  vk::DeviceMemory stagingBufferMemory;
-  ru::vCreateBuffer(mDevice, mPhysicalDevice, bufferSize, vk::BufferUsageFlagBits::eTransferSrc,
-                    vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent, stagingBuffer,
-                    stagingBufferMemory);
+    vk::CommandBufferAllocateInfo allocInfo;
+    allocInfo.setLevel(vk::CommandBufferLevel::ePrimary).setCommandPool(mUploadCommandPool).setCommandBufferCount(1);
+    commandBuffer = mDevice.allocateCommandBuffers(allocInfo)[0];
 
-  void* data;
-  VK_TRY(mDevice.mapMemory(stagingBufferMemory, 0, bufferSize, vk::MemoryMapFlags(0), &data), "Failed to map memory");
-  memcpy(data, Vertices.data(), bufferSize);
-  mDevice.unmapMemory(stagingBufferMemory);
+    commandBuffer.begin(vk::CommandBufferBeginInfo().setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+    commandBuffer.copyBuffer(srcBuffer, dstBuffer, vk::BufferCopy().setSize(size));
+    commandBuffer.end();
+  }
 
-  ru::vCreateBuffer(mDevice, mPhysicalDevice, bufferSize,
-                    vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eVertexBuffer,
-                    vk::MemoryPropertyFlagBits::eDeviceLocal, mVertexBuffer, mVertexBufferMemory);
-  ru::vCopyBuffer(mDevice, mCommandPool, mGraphicsQueue, stagingBuffer, mVertexBuffer, bufferSize);
+  vk::Fence fence = mDevice.createFence(vk::FenceCreateInfo());
+  {
+    std::lock_guard lock(mQueueMutex);
+    mGraphicsQueue.submit(vk::SubmitInfo().setCommandBuffers(commandBuffer), fence);
+  }
 
-  mDevice.destroyBuffer(stagingBuffer);
-  mDevice.freeMemory(stagingBufferMemory);
+  co_await AwaitFence(fence);
+
+  mDevice.destroyFence(fence);
+  {
+    std::lock_guard lock(mUploadMutex);
+    mDevice.freeCommandBuffers(mUploadCommandPool, commandBuffer);
+  }
 }
 
-void Renderer::vCreateIndexBuffer()
+Task<void> Renderer::vCreateGeometryBuffers()
 {
-  vk::DeviceSize bufferSize = sizeof(Indices[0]) * Indices.size();
+  // Both copies are in flight at once instead of one waitIdle each.
+  JobHandle vertices =
+      Spawn(*mThreadPool, vUploadBuffer(Vertices.data(), sizeof(Vertices[0]) * Vertices.size(),
+                                        vk::BufferUsageFlagBits::eVertexBuffer, mVertexBuffer, mVertexBufferMemory));
+  co_await vUploadBuffer(Indices.data(), sizeof(Indices[0]) * Indices.size(), vk::BufferUsageFlagBits::eIndexBuffer,
+                         mIndexBuffer, mIndexBufferMemory);
+  co_await AwaitJob(*mThreadPool, vertices);
+}
 
+Task<void> Renderer::vUploadBuffer(const void* data, vk::DeviceSize size, vk::BufferUsageFlags usage,
+                                   vk::Buffer& outBuffer, vk::DeviceMemory& outMemory)
+{
   vk::Buffer stagingBuffer;
   vk::DeviceMemory stagingBufferMemory;
-  ru::vCreateBuffer(mDevice, mPhysicalDevice, bufferSize, vk::BufferUsageFlagBits::eTransferSrc,
+  ru::vCreateBuffer(mDevice, mPhysicalDevice, size, vk::BufferUsageFlagBits::eTransferSrc,
                     vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent, stagingBuffer,
                     stagingBufferMemory);
 
-  void* data;
-  VK_TRY(mDevice.mapMemory(stagingBufferMemory, 0, bufferSize, vk::MemoryMapFlags(0), &data), "Failed to map memory");
-  memcpy(data, Indices.data(), bufferSize);
+  void* mapped;
+  VK_TRY(mDevice.mapMemory(stagingBufferMemory, 0, size, vk::MemoryMapFlags(0), &mapped), "Failed to map memory");
+  memcpy(mapped, data, size);
   mDevice.unmapMemory(stagingBufferMemory);
 
-  ru::vCreateBuffer(mDevice, mPhysicalDevice, bufferSize,
-                    vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eIndexBuffer,
-                    vk::MemoryPropertyFlagBits::eDeviceLocal, mIndexBuffer, mIndexBufferMemory);
-  ru::vCopyBuffer(mDevice, mCommandPool, mGraphicsQueue, stagingBuffer, mIndexBuffer, bufferSize);
+  ru::vCreateBuffer(mDevice, mPhysicalDevice, size, vk::BufferUsageFlagBits::eTransferDst | usage,
+                    vk::MemoryPropertyFlagBits::eDeviceLocal, outBuffer, outMemory);
+  co_await CopyBufferAsync(stagingBuffer, outBuffer, size);
 
   mDevice.destroyBuffer(stagingBuffer);
   mDevice.freeMemory(stagingBufferMemory);
 }
 
+void Renderer::vCreateInstanceBuffers()
+{
+  mFrameInstanceBuffers.resize(MAX_FRAMES_IN_FLIGHT, nullptr);
+  for (u32 i = 0; i < NumInstanceBuffers; i++)
+  {
+    InstanceBuffer* buffer = new InstanceBuffer(mDevice, mPhysicalDevice);
+    mInstanceBuffers.push_back(buffer);
+    mFreeInstanceBuffers.TryPush(buffer);
+  }
+}
+
+InstanceBuffer* Renderer::AcquireInstanceBuffer()
+{
+  InstanceBuffer* buffer = nullptr;
+  if (mThreadPool)
+  {
+    mThreadPool->WaitUntil([this, &buffer]() { return mFreeInstanceBuffers.TryPop(buffer); });
+  }
+  else
+  {
+    while (!mFreeInstanceBuffers.TryPop(buffer))
+    {
+      std::this_thread::yield();
+    }
+  }
+
+  buffer->Clear();
+  return buffer;
+}
+
+void Renderer::ReleaseInstanceBuffer(InstanceBuffer* buffer)
+{
+  if (buffer)
+  {
+    mFreeInstanceBuffers.TryPush(buffer);
+  }
+}
+
 void Renderer::vCreateUniformBuffers()
 {
   vk::DeviceSize bufferSize = sizeof(UniformBufferObject);
@@ -725,7 +808,8 @@ void Renderer::vCreateCommandBuffers()
   mCommandBuffers = mDevice.allocateCommandBuffers(allocInfo);
 }
 
-void Renderer::vRecordCommandBuffer(const vk::CommandBuffer& commandBuffer, u32 imageIndex)
+void Renderer::vRecordCommandBuffer(const vk::CommandBuffer& commandBuffer, u32 imageIndex,
+                                    const RenderSnapshot& snapshot)
 {
   vk::CommandBufferBeginInfo beginInfo;
 
@@ -751,30 +835,56 @@ void Renderer::vRecordCommandBuffer(const vk::CommandBuffer& commandBuffer, u32
   commandBuffer.setLineWidth(10.0f);
   commandBuffer.setScissor(0, vk::Rect2D().setOffset({0, 0}).setExtent(mSwapchainExtent));
 
-  vk::Buffer buffers[] = {mVertexBuffer};
-  vk::DeviceSize offsets[] = {0};
-
   // vUpdateUniformBuffer(mCurrentFrame);
 
-  commandBuffer.bindVertexBuffers(0, 1, buffers, offsets);
-  commandBuffer.bindIndexBuffer(mIndexBuffer, 0, vk::IndexType::eUint16);
-  commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, mPipelineLayout, 0, mDescriptorSets[mCurrentFrame],
-                                   nullptr);
-
-  commandBuffer.drawIndexed(static_cast<u32>(Indices.size()), 1, 0, 0, 0);
+  const InstanceBuffer* instances = snapshot.Instances;
+  if (instances && instances->Size() > 0)
+  {
+    vk::Buffer buffers[] = {mVertexBuffer, instances->GetBuffer()};
+    vk::DeviceSize offsets[] = {0, 0};
+
+    commandBuffer.bindVertexBuffers(0, 2, buffers, offsets);
+    commandBuffer.bindIndexBuffer(mIndexBuffer, 0, vk::IndexType::eUint16);
+    commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, mPipelineLayout, 0,
+                                     mDescriptorSets[mCurrentFrame], nullptr);
+    commandBuffer.pushConstants(mPipelineLayout, vk::ShaderStageFlagBits::eVertex, 0, sizeof(f32), &snapshot.Alpha);
+
+    // Extraction keeps each shape contiguous, so one pipeline and one draw per
+    // shape cover every instance.
+    for (u32 shape = 0; shape < (u32)EShape::NumShapes; shape++)
+    {
+      const RenderInstanceRange& range = snapshot.ShapeRanges[shape];
+      if (range.Count > 0)
+      {
+        const ShapeMesh& mesh = ShapeMeshes[shape];
+        commandBuffer.drawIndexed(mesh.IndexCount, range.Count, mesh.FirstIndex, mesh.VertexOffset, range.First);
+      }
+    }
+  }
 
-  ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), commandBuffer);
+  const RenderUi& ui = snapshot.Ui;
+  ImDrawData drawData;
+  drawData.Valid = true;
+  drawData.DisplayPos = ImVec2(ui.DisplayPos.x, ui.DisplayPos.y);
+  drawData.DisplaySize = ImVec2(ui.DisplaySize.x, ui.DisplaySize.y);
+  drawData.FramebufferScale = ImVec2(ui.FramebufferScale.x, ui.FramebufferScale.y);
+  for (ImDrawList* list : ui.DrawLists)
+  {
+    drawData.AddDrawList(list);
+  }
+  ImGui_ImplVulkan_RenderDrawData(&drawData, commandBuffer);
 
   commandBuffer.endRenderPass();
   commandBuffer.end();
 }
 
-void Renderer::UpdateCamera(u32 currentImage)
+void Renderer::UpdateCamera(u32 currentImage, const RenderCamera& camera)
 {
   UniformBufferObject ubo{};
   ubo.model = m4(1.f);
-  ubo.view = glm::lookAt(glm::vec3(2.f, 2.f, 2.f), glm::vec3(0.f, 0.f, 0.f), glm::vec3(0.f, 0.f, 1.f));
-  ubo.proj = glm::perspective(glm::radians(45.f), mSwapchainExtent.width / (f32)mSwapchainExtent.height, 0.1f, 10.f);
+  ubo.view = glm::lookAt(camera.Eye, camera.Target, glm::vec3(0.f, 0.f, 1.f));
+  ubo.proj =
+      glm::perspective(glm::radians(camera.Fov), mSwapchainExtent.width / (f32)mSwapchainExtent.height, 0.1f, 10.f);
   ubo.proj[1][1] *= -1;
 
   /*size_t size = sizeof(UniformBufferObject) - offsetof(UniformBufferObject, view);*/
@@ -831,15 +941,21 @@ void Renderer::ImGuiInit()
   init_info.ImageCount = MAX_FRAMES_IN_FLIGHT;
   init_info.MSAASamples = VK_SAMPLE_COUNT_1_BIT;
   ImGui_ImplVulkan_Init(&init_info);
+
+  // Upload the font atlas now, NewFrame runs on the game thread and must not
+  // submit to the queue the render thread uses.
+  std::lock_guard lock(mQueueMutex);
+  ImGui_ImplVulkan_CreateFontsTexture();
 }
 
 void Renderer::vRecreateSwapchain()
 {
-  i32 width = 0, height = 0;
-  while (width == 0 || height == 0)
+  // Runs on the render thread, so it must not pump GLFW events. A minimized
+  // window keeps the resize pending until it has a size again.
+  if (mWindow->GetWidth() == 0 || mWindow->GetHeight() == 0)
   {
-    glfwGetFramebufferSize(mWindow->GetGlfwWindow(), &width, &height);
-    glfwWaitEvents();
+    mWindow->SetFramebufferResized(true);
+    return;
   }
 
   mDevice.waitIdle();
@@ -868,7 +984,7 @@ void Renderer::vCleanupSwapchain()
   mDevice.destroySwapchainKHR(mSwapchain);
 }
 
-void Renderer::ImGuiDraw()
+void Renderer::ImGuiDraw(RenderSnapshot& snapshot)
 {
   ImGui_ImplVulkan_NewFrame();
   ImGui_ImplGlfw_NewFrame();
@@ -880,18 +996,159 @@ void Renderer::ImGuiDraw()
 
   ImGui::End();
 
+  ImGuiDrawThreadStats();
+  ImGuiDrawSystemTimings(snapshot);
+
   ImGui::Render();
+
+  // The next NewFrame reuses ImGui's draw lists, the render thread gets copies.
+  const ImDrawData* drawData = ImGui::GetDrawData();
+  RenderUi& ui = snapshot.Ui;
+  ui.Clear();
+  for (ImDrawList* list : drawData->CmdLists)
+  {
+    ui.DrawLists.push_back(list->CloneOutput());
+  }
+  ui.DisplayPos = v2(drawData->DisplayPos.x, drawData->DisplayPos.y);
+  ui.DisplaySize = v2(drawData->DisplaySize.x, drawData->DisplaySize.y);
+  ui.FramebufferScale = v2(drawData->FramebufferScale.x, drawData->FramebufferScale.y);
 }
 
-void Renderer::DrawFrame()
+static const char* WorkerThreadTypeName(EWorkerThreadType type)
 {
-  vk::Result result = mDevice.waitForFences(mInFlightFences[mCurrentFrame], vk::True, UINT64_MAX);
+  switch (type)
+  {
+  case EWorkerThreadType::Render:
+    return "Render";
+  case EWorkerThreadType::GameWrite:
+    return "GameWrite";
+  case EWorkerThreadType::GameRead:
+    return "GameRead";
+  case EWorkerThreadType::Network:
+    return "Network";
+  case EWorkerThreadType::General:
+    return "General";
+  default:
+    return "Undefined";
+  }
+}
+
+void Renderer::ImGuiDrawThreadStats()
+{
+  if (!mThreadPool)
+  {
+    return;
+  }
+
+  std::swap(mThreadStats, mPrevThreadStats);
+  mThreadPool->GetStats(mThreadStats);
+
+  ImGui::Begin("Threads");
+  ImGui::Text("Queued: %llu  Injected: %llu", (unsigned long long)mThreadStats.QueuedJobs,
+              (unsigned long long)mThreadStats.InjectedJobs);
+
+  if (ImGui::BeginTable("Workers", 6, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+  {
+    ImGui::TableSetupColumn("Id");
+    ImGui::TableSetupColumn("Type");
+    ImGui::TableSetupColumn("Busy %");
+    ImGui::TableSetupColumn("Jobs/frame");
+    ImGui::TableSetupColumn("Steals/frame");
+    ImGui::TableSetupColumn("Queue");
+    ImGui::TableHeadersRow();
+
+    u64 wallNs = mThreadStats.TimestampNs - mPrevThreadStats.TimestampNs;
+    bool bHasPrevious = mPrevThreadStats.Workers.size() == mThreadStats.Workers.size() && wallNs > 0;
+
+    for (size_t i = 0; i < mThreadStats.Workers.size(); i++)
+    {
+      const WorkerStatsSnapshot& worker = mThreadStats.Workers[i];
+      WorkerStatsSnapshot previous = bHasPrevious ? mPrevThreadStats.Workers[i] : worker;
+
+      ImGui::TableNextRow();
+      ImGui::TableNextColumn();
+      ImGui::Text("%d", (i32)worker.Id);
+      ImGui::TableNextColumn();
+      ImGui::TextUnformatted(WorkerThreadTypeName(worker.Type));
+      ImGui::TableNextColumn();
+      ImGui::Text("%.1f", bHasPrevious ? 100.0 * (f64)(worker.BusyNs - previous.BusyNs) / (f64)wallNs : 0.0);
+      ImGui::TableNextColumn();
+      ImGui::Text("%llu", (unsigned long long)(worker.JobsExecuted - previous.JobsExecuted));
+      ImGui::TableNextColumn();
+      ImGui::Text("%llu", (unsigned long long)(worker.Steals - previous.Steals));
+      ImGui::TableNextColumn();
+      ImGui::Text("%llu", (unsigned long long)worker.QueueDepth);
+    }
+    ImGui::EndTable();
+  }
+
+  ImGui::End();
+}
+
+void Renderer::ImGuiDrawSystemTimings(const RenderSnapshot& snapshot)
+{
+  ImGui::Begin("Systems");
+
+  if (ImGui::BeginTable("Timings", 5, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+  {
+    ImGui::TableSetupColumn("System");
+    ImGui::TableSetupColumn("Last ms");
+    ImGui::TableSetupColumn("Min ms");
+    ImGui::TableSetupColumn("Avg ms");
+    ImGui::TableSetupColumn("P99 ms");
+    ImGui::TableHeadersRow();
+
+    for (const SystemTimingStats& system : snapshot.SystemTimings)
+    {
+      ImGui::TableNextRow();
+      ImGui::TableNextColumn();
+      ImGui::TextUnformatted(system.Name.c_str());
+      ImGui::TableNextColumn();
+      ImGui::Text("%.3f", system.LastMs);
+      ImGui::TableNextColumn();
+      ImGui::Text("%.3f", system.MinMs);
+      ImGui::TableNextColumn();
+      ImGui::Text("%.3f", system.AvgMs);
+      ImGui::TableNextColumn();
+      ImGui::Text("%.3f", system.P99Ms);
+    }
+    ImGui::EndTable();
+  }
+
+  ImGui::End();
+}
+
+void Renderer::DrawFrame(const RenderSnapshot& snapshot)
+{
+  if (mWindow->GetFramebufferResized() && (mWindow->GetWidth() == 0 || mWindow->GetHeight() == 0))
+  {
+    ReleaseInstanceBuffer(snapshot.Instances);
+    return;
+  }
+
+  // Run jobs while the GPU is still busy with this frame's resources, unless we
+  // are on the dedicated render thread.
+  vk::Result result = vk::Result::eSuccess;
+  if (mThreadPool && mThreadPool->CanHelp())
+  {
+    mThreadPool->WaitUntil(
+        [this]() { return mDevice.getFenceStatus(mInFlightFences[mCurrentFrame]) != vk::Result::eNotReady; });
+  }
+  else
+  {
+    result = mDevice.waitForFences(mInFlightFences[mCurrentFrame], vk::True, UINT64_MAX);
+  }
+
+  // The GPU is done with whatever this frame slot drew last time.
+  ReleaseInstanceBuffer(mFrameInstanceBuffers[mCurrentFrame]);
+  mFrameInstanceBuffers[mCurrentFrame] = nullptr;
 
   vk::ResultValue resultVal =
       mDevice.acquireNextImageKHR(mSwapchain, UINT64_MAX, mImageAvailableSemaphores[mCurrentFrame]);
 
   if (resultVal.result == vk::Result::eErrorOutOfDateKHR)
   {
+    ReleaseInstanceBuffer(snapshot.Instances);
     vRecreateSwapchain();
     return;
   }
@@ -902,11 +1159,14 @@ void Renderer::DrawFrame()
 
   mDevice.resetFences(mInFlightFences[mCurrentFrame]);
 
+  UpdateCamera(mCurrentFrame, snapshot.Camera);
+
   u32 imageIndex = resultVal.value;
 
   mCommandBuffers[mCurrentFrame].reset(vk::CommandBufferResetFlags(0));
 
-  vRecordCommandBuffer(mCommandBuffers[mCurrentFrame], imageIndex);
+  vRecordCommandBuffer(mCommandBuffers[mCurrentFrame], imageIndex, snapshot);
+  mFrameInstanceBuffers[mCurrentFrame] = snapshot.Instances;
 
   vk::SubmitInfo submitInfo;
   vk::PipelineStageFlags waitStages[]{vk::PipelineStageFlagBits::eColorAttachmentOutput};
@@ -915,18 +1175,22 @@ void Renderer::DrawFrame()
       .setCommandBuffers(mCommandBuffers[mCurrentFrame])
       .setSignalSemaphores(mRenderFinishedSemaphores[mCurrentFrame]);
 
-  mGraphicsQueue.submit(submitInfo, mInFlightFences[mCurrentFrame]);
-
   vk::PresentInfoKHR presentInfo;
   presentInfo.setWaitSemaphores(mRenderFinishedSemaphores[mCurrentFrame]);
   presentInfo.setSwapchains(mSwapchain).setImageIndices(imageIndex);
 
-  try
-  {
-    result = mPresentQueue.presentKHR(presentInfo);
-  }
-  catch (const vk::OutOfDateKHRError& e)
   {
+    std::lock_guard lock(mQueueMutex);
+    mGraphicsQueue.submit(submitInfo, mInFlightFences[mCurrentFrame]);
+
+    try
+    {
+      result = mPresentQueue.presentKHR(presentInfo);
+    }
+    catch (const vk::OutOfDateKHRError& e)
+    {
+      result = vk::Result::eErrorOutOfDateKHR;
+    }
   }
 
   if (result == vk::Result::eErrorOutOfDateKHR || result == vk::Result::eSuboptimalKHR ||
@@ -957,6 +1221,10 @@ void Renderer::Clean()
 
   mDevice.waitIdle();
 
+  mFenceWaiter->Stop();
+  delete mFenceWaiter;
+  mFenceWaiter = nullptr;
+
   ImGuiShutdown();
 
   vCleanupSwapchain();
@@ -980,6 +1248,13 @@ void Renderer::Clean()
   mDevice.destroyBuffer(mVertexBuffer);
   mDevice.freeMemory(mVertexBufferMemory);
 
+  for (InstanceBuffer* buffer : mInstanceBuffers)
+  {
+    delete buffer;
+  }
+  mInstanceBuffers.clear();
+  mFrameInstanceBuffers.clear();
+
   for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
   {
     mDevice.destroySemaphore(mRenderFinishedSemaphores[i]);
@@ -987,6 +1262,7 @@ void Renderer::Clean()
     mDevice.destroyFence(mInFlightFences[i]);
   }
 
+  mDevice.destroyCommandPool(mUploadCommandPool);
   mDevice.destroyCommandPool(mCommandPool);
   mDevice.destroy();
 
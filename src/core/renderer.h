@@ -3,6 +3,12 @@
 
 #include "backends/imgui_impl_vulkan.h"
 #include "core.h"
+#include "core/fence_waiter.h"
+#include "core/render_snapshot.h"
+#include "core/threads/spsc_queue.h"
+#include "core/threads/task.h"
+#include "core/threads/thread_pool.h"
+#include <mutex>
 #include <vector>
 #include <vulkan/vulkan.hpp>
 #include <vulkan/vulkan_handles.hpp>
@@ -46,6 +52,13 @@ class Renderer
   vk::PipelineLayout mPipelineLayout;
   vk::RenderPass mRenderPass;
   vk::CommandPool mCommandPool;
+  vk::CommandPool mUploadCommandPool;
+
+  // Queues and command pools are externally synchronized in Vulkan, uploads
+  // may be recorded and submitted from pool workers while the render thread
+  // draws.
+  std::mutex mQueueMutex;
+  std::mutex mUploadMutex;
 
   std::vector<vk::CommandBuffer> mCommandBuffers;
   std::vector<vk::Semaphore> mImageAvailableSemaphores;
@@ -55,6 +68,8 @@ class Renderer
   std::vector<vk::Framebuffer> mSwapChainFrameBuffers;
 
   class Window* mWindow;
+  class ThreadPool* mThreadPool{};
+  FenceWaiter* mFenceWaiter{};
 
   u32 mCurrentFrame = 0;
 
@@ -65,6 +80,16 @@ class Renderer
   vk::Buffer mIndexBuffer;
   vk::DeviceMemory mIndexBufferMemory;
 
+  // One buffer per frame in flight, one being extracted into and one spare, so
+  // the game thread never waits on the GPU to get one.
+  static constexpr u32 NumInstanceBuffers = 4;
+
+  // Instance buffers go back to the game thread through mFreeInstanceBuffers
+  // once the frame that drew them has finished on the GPU.
+  std::vector<class InstanceBuffer*> mInstanceBuffers;
+  std::vector<class InstanceBuffer*> mFrameInstanceBuffers;
+  SPSCQueue<class InstanceBuffer*> mFreeInstanceBuffers{NumInstanceBuffers};
+
   std::vector<vk::Buffer> mUniformBuffers;
   std::vector<vk::DeviceMemory> mUniformBuffersMemory;
   std::vector<void*> mUniformBuffersMapped;
@@ -76,6 +101,9 @@ class Renderer
   vk::DescriptorPool mDescriptorPool;
   std::vector<vk::DescriptorSet> mDescriptorSets;
 
+  ThreadPoolStats mThreadStats{};
+  ThreadPoolStats mPrevThreadStats{};
+
 public:
   const vk::PhysicalDevice& GetPhysicalDevice() const;
   const vk::Device& GetDevice() const;
@@ -83,7 +111,7 @@ public:
   const Window& GetWindow() const;
 
 public:
-  void Init(class Window* window);
+  void Init(class Window* window, class ThreadPool* threadPool);
 
   void vCreateInstance();
   void vGetExtensions();
@@ -102,11 +130,15 @@ public:
   void vCreateImageViews();
   void vCreateRenderPass();
   void vCreateDescriptorSetLayout();
-  void vCreateGraphicsPipeline();
+  void vCreateGraphicsPipeline(const std::vector<char>& vertCode, const std::vector<char>& fragCode);
   void vCreateFrameBuffers();
   void vCreateCommandPool();
-  void vCreateVertexBuffer();
-  void vCreateIndexBuffer();
+  Task<void> vLoadShader(std::string name, std::vector<char>& outCode);
+  // Vertex and index uploads run on the pool, each waiting on its own fence.
+  Task<void> vCreateGeometryBuffers();
+  Task<void> vUploadBuffer(const void* data, vk::DeviceSize size, vk::BufferUsageFlags usage, vk::Buffer& outBuffer,
+                           vk::DeviceMemory& outMemory);
+  void vCreateInstanceBuffers();
   void vCreateUniformBuffers();
   void vCreateDescriptorPool();
   void vCreateDescriptorSets();
@@ -114,17 +146,33 @@ public:
   void vCreateSyncObjects();
 
   void ImGuiInit();
-  void ImGuiDraw();
+  // Game thread only, next to GLFW's input callbacks. Builds the UI and
+  // copies its draw lists into the snapshot.
+  void ImGuiDraw(RenderSnapshot& snapshot);
+  void ImGuiDrawThreadStats();
+  void ImGuiDrawSystemTimings(const RenderSnapshot& snapshot);
   void ImGuiShutdown();
 
   void vRecreateSwapchain();
   void vCleanupSwapchain();
 
-  void vRecordCommandBuffer(const vk::CommandBuffer& CommandBuffer, u32 imageIndex);
+  void vRecordCommandBuffer(const vk::CommandBuffer& CommandBuffer, u32 imageIndex, const RenderSnapshot& snapshot);
   void vUpdateUniformBuffer(u32 currentImage);
-  void UpdateCamera(u32 currentImage);
+  void UpdateCamera(u32 currentImage, const RenderCamera& camera);
+
+  void DrawFrame(const RenderSnapshot& snapshot);
+
+  // Game thread only. Returns an empty instance buffer for the next snapshot,
+  // the render thread releases it once the snapshot has been drawn.
+  class InstanceBuffer* AcquireInstanceBuffer();
+  // Render thread only.
+  void ReleaseInstanceBuffer(class InstanceBuffer* buffer);
 
-  void DrawFrame();
+  auto AwaitFence(const vk::Fence& fence)
+  {
+    return mFenceWaiter->Await(fence);
+  }
+  Task<void> CopyBufferAsync(vk::Buffer srcBuffer, vk::Buffer dstBuffer, vk::DeviceSize size);
 
   void Clean();
 };
@@ -0,0 +1,78 @@
+#ifndef TK_SIMULATION_CLOCK_H
+#define TK_SIMULATION_CLOCK_H
+
+#include "core/types.h"
+
+namespace tk
+{
+
+struct SimulationConfig
+{
+  u32 TickRate = 60;
+  // Steps run per frame at most, the rest of a long frame is dropped so a
+  // slow frame can't snowball into ever more steps.
+  u32 MaxCatchUpSteps = 5;
+};
+
+// Fixed-step accumulator. Frame time goes in, whole simulation steps come out,
+// and the remainder is the interpolation factor between the last two states.
+class SimulationClock
+{
+  f64 mStepTime = 1.0 / 60.0;
+  u32 mMaxCatchUpSteps = 5;
+  f64 mAccumulator = 0.0;
+  u64 mTick = 0;
+
+public:
+  SimulationClock() = default;
+  SimulationClock(const SimulationConfig& config)
+      : mStepTime(1.0 / (f64)(config.TickRate ? config.TickRate : 1)), mMaxCatchUpSteps(config.MaxCatchUpSteps)
+  {
+  }
+
+  // Returns the number of steps to run for this frame.
+  u32 Advance(f64 frameTime)
+  {
+    mAccumulator += frameTime;
+    u32 steps = (u32)(mAccumulator / mStepTime);
+    if (steps > mMaxCatchUpSteps)
+    {
+      steps = mMaxCatchUpSteps;
+      mAccumulator = mStepTime * steps;
+    }
+    mAccumulator -= mStepTime * steps;
+    mTick += steps;
+    return steps;
+  }
+
+  // Gives back steps that Advance returned but that didn't run, they are run
+  // by later calls instead.
+  void Defer(u32 steps)
+  {
+    mAccumulator += mStepTime * steps;
+    mTick -= steps;
+  }
+
+  f32 GetStepTime() const
+  {
+    return (f32)mStepTime;
+  }
+
+  // 0 right after a step, towards 1 just before the next one. Deferred steps
+  // can push the accumulator past a whole step, rendering then holds the
+  // latest state instead of extrapolating.
+  f32 GetAlpha() const
+  {
+    f64 alpha = mAccumulator / mStepTime;
+    return (f32)(alpha < 1.0 ? alpha : 1.0);
+  }
+
+  u64 GetTick() const
+  {
+    return mTick;
+  }
+};
+
+} // namespace tk
+
+#endif // !TK_SIMULATION_CLOCK_H
@@ -0,0 +1,83 @@
+#ifndef TK_CORE_SYSTEMS_H
+#define TK_CORE_SYSTEMS_H
+
+#include "core/components/c_local_transform.h"
+#include "core/components/c_parent.h"
+#include "core/components/c_prev_transform.h"
+#include "core/components/c_shape.h"
+#include "core/components/c_transform2d.h"
+#include "core/components/c_velocity.h"
+#include "core/ecs/change_tracker.h"
+#include "core/ecs/registry_snapshot.h"
+#include "core/systems/extract/s_extract_shape.h"
+#include "core/systems/system_pipeline.h"
+#include "core/systems/update/s_hierarchy.h"
+#include "core/systems/update/s_integrate.h"
+#include "core/systems/update/s_prev_transform.h"
+#include "core/systems/update/s_shape.h"
+#include "core/systems/update/s_spatial_grid.h"
+
+namespace tk
+{
+
+// Components saved by world snapshots. CPrevTransform comes after CTransform
+// so its restored values win over the copies made by its hooks, when those
+// are connected.
+using CoreSnapshot = RegistrySnapshot<CTransform, CPrevTransform, CVelocity, CShape, CParent, CLocalTransform>;
+
+// Core systems, listed in the order they run within their phase. Every world
+// runs its own instance.
+class CoreSystems : public SystemPipeline<SPrevTransform, SIntegrate, SHierarchy, SSpatialGrid, SShape, SExtractShape>
+{
+public:
+  // Change trackers the core systems consume. Connected before Init and
+  // disconnected after Shutdown.
+  static void ConnectTrackers(Registry& registry)
+  {
+    ComponentChanges<CTransform>::Connect(registry);
+    ComponentChanges<CPrevTransform>::Connect(registry);
+    ComponentChanges<CShape>::Connect(registry);
+    ComponentChanges<CLocalTransform>::Connect(registry);
+  }
+
+  static void DisconnectTrackers(Registry& registry)
+  {
+    ComponentChanges<CLocalTransform>::Disconnect(registry);
+    ComponentChanges<CShape>::Disconnect(registry);
+    ComponentChanges<CPrevTransform>::Disconnect(registry);
+    ComponentChanges<CTransform>::Disconnect(registry);
+  }
+
+  static void SuspendTrackers(Registry& registry)
+  {
+    ComponentChanges<CLocalTransform>::Suspend(registry);
+    ComponentChanges<CShape>::Suspend(registry);
+    ComponentChanges<CPrevTransform>::Suspend(registry);
+    ComponentChanges<CTransform>::Suspend(registry);
+  }
+
+  static void ResumeTrackers(Registry& registry)
+  {
+    ComponentChanges<CTransform>::Resume(registry);
+    ComponentChanges<CPrevTransform>::Resume(registry);
+    ComponentChanges<CShape>::Resume(registry);
+    ComponentChanges<CLocalTransform>::Resume(registry);
+  }
+
+  // Loads a CoreSnapshot with the hooks of the systems and trackers
+  // disconnected, then rebuilds every mirror once instead of following the
+  // clear and the inserts entity by entity.
+  bool LoadSnapshot(Registry& registry, const u8* data, size_t size)
+  {
+    Suspend();
+    SuspendTrackers(registry);
+    bool bOk = CoreSnapshot::Load(registry, data, size);
+    ResumeTrackers(registry);
+    Resume();
+    return bOk;
+  }
+};
+
+} // namespace tk
+
+#endif // !TK_CORE_SYSTEMS_H
@@ -0,0 +1,21 @@
+#ifndef TECH_S_EXTRACT_H
+#define TECH_S_EXTRACT_H
+
+#include "../system.h"
+#include "core/enums/e_system_phase.h"
+#include "core/render_snapshot.h"
+
+namespace tk
+{
+
+// Copies game state into the render snapshot. Derived systems provide
+// void Extract(RenderSnapshot&), it is only ever called statically.
+class SExtract : public System
+{
+public:
+  static constexpr ESystemPhase Phase = ESystemPhase::Extract;
+};
+
+} // namespace tk
+
+#endif // TECH_S_EXTRACT_H
@@ -0,0 +1,119 @@
+#include "s_extract_shape.h"
+#include "core/components/c_prev_transform.h"
+#include "core/components/c_shape.h"
+#include "core/components/c_transform2d.h"
+#include "core/instance_buffer.h"
+
+namespace tk
+{
+
+namespace
+{
+
+RenderInstance MakeInstance(const CShape& shape, const CTransform& transform, const CPrevTransform& prev)
+{
+  return {transform.Position, transform.Rotation, transform.Scale, prev.Position, prev.Rotation, prev.Scale,
+          shape.shape};
+}
+
+} // namespace
+
+void SExtractShape::Init()
+{
+  mShapes.Connect(GetRegistry());
+}
+
+void SExtractShape::Shutdown()
+{
+  mShapes.Disconnect();
+  mBufferStates.clear();
+}
+
+void SExtractShape::Suspend()
+{
+  mShapes.Disconnect();
+}
+
+// Connecting again sorts the group by shape once.
+void SExtractShape::Resume()
+{
+  mShapes.Connect(GetRegistry());
+}
+
+void SExtractShape::Extract(RenderSnapshot& snapshot)
+{
+  if (!snapshot.Instances)
+  {
+    return;
+  }
+
+  mShapes.Refresh();
+
+  InstanceBuffer& instances = *snapshot.Instances;
+  u32 first = instances.Size();
+  u32 count = mShapes.Size();
+  instances.Resize(first + count);
+
+  ChangeTracker& transformChanges = GetChanges<CTransform>();
+  ChangeTracker& prevTransformChanges = GetChanges<CPrevTransform>();
+  ChangeTracker& shapeChanges = GetChanges<CShape>();
+
+  // Groups iterate their packed arrays back to front, so instance order is
+  // mirrored: packed index i lands at first + count - 1 - i.
+  BufferState& state = GetBufferState(&instances);
+  bool bFull = state.LayoutVersion != mShapes.GetLayoutVersion() || state.First != first || state.Count != count ||
+               !transformChanges.IsValid(state.TransformTick) ||
+               !prevTransformChanges.IsValid(state.PrevTransformTick) || !shapeChanges.IsValid(state.ShapeTick);
+
+  const auto& group = mShapes.GetGroup();
+  if (bFull)
+  {
+    u32 index = first;
+    group.each([&instances, &index](const CShape& shape, const CTransform& transform, const CPrevTransform& prev) {
+      instances.Set(index++, MakeInstance(shape, transform, prev));
+    });
+  }
+  else
+  {
+    const auto& packed = GetRegistry().storage<CShape>();
+    auto update = [&](entt::entity entity) {
+      if (group.contains(entity))
+      {
+        u32 index = first + count - 1 - (u32)packed.index(entity);
+        auto [shape, transform, prev] = group.get<CShape, CTransform, CPrevTransform>(entity);
+        instances.Set(index, MakeInstance(shape, transform, prev));
+      }
+    };
+    transformChanges.ForEachChangedSince(state.TransformTick, update);
+    prevTransformChanges.ForEachChangedSince(state.PrevTransformTick, update);
+    shapeChanges.ForEachChangedSince(state.ShapeTick, update);
+  }
+
+  state.TransformTick = transformChanges.Advance();
+  state.PrevTransformTick = prevTransformChanges.Advance();
+  state.ShapeTick = shapeChanges.Advance();
+  state.LayoutVersion = mShapes.GetLayoutVersion();
+  state.First = first;
+  state.Count = count;
+
+  for (u32 shape = 0; shape < ShapeGroup::NumShapes; shape++)
+  {
+    snapshot.ShapeRanges[shape] = {first + count - mShapes.End((EShape)shape),
+                                   mShapes.End((EShape)shape) - mShapes.Begin((EShape)shape)};
+  }
+}
+
+SExtractShape::BufferState& SExtractShape::GetBufferState(const InstanceBuffer* buffer)
+{
+  for (BufferState& state : mBufferStates)
+  {
+    if (state.Buffer == buffer)
+    {
+      return state;
+    }
+  }
+  mBufferStates.push_back({buffer});
+  return mBufferStates.back();
+}
+
+} // namespace tk
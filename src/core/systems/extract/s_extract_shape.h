@@ -0,0 +1,43 @@
+#ifndef TKS_EXTRACT_SHAPE_H
+#define TKS_EXTRACT_SHAPE_H
+
+#include "core/dynamic_array.h"
+#include "core/ecs/shape_group.h"
+#include "extract_system.h"
+
+namespace tk
+{
+
+// Writes one instance per shape entity. Instance buffers are reused round
+// robin, each remembers what it was last filled with so only entities changed
+// since then are rewritten, unless the group's layout moved.
+class SExtractShape final : public SExtract
+{
+  struct BufferState
+  {
+    const class InstanceBuffer* Buffer = nullptr;
+    u32 TransformTick = ChangeTracker::NeverTick;
+    u32 PrevTransformTick = ChangeTracker::NeverTick;
+    u32 ShapeTick = ChangeTracker::NeverTick;
+    u64 LayoutVersion = 0;
+    u32 First = 0;
+    u32 Count = 0;
+  };
+
+  ShapeGroup mShapes = {};
+  DynamicArray<BufferState> mBufferStates = {};
+
+public:
+  virtual void Init() override;
+  virtual void Shutdown() override;
+  virtual void Suspend() override;
+  virtual void Resume() override;
+  void Extract(RenderSnapshot& snapshot);
+
+private:
+  BufferState& GetBufferState(const class InstanceBuffer* buffer);
+};
+
+} // namespace tk
+
+#endif // !TKS_EXTRACT_SHAPE_H
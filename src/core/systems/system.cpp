@@ -1,10 +1,31 @@
 #include "system.h"
+#include "core/engine.h"
+#include "core/world.h"
 
 namespace tk
 {
 
 Registry& System::GetRegistry()
 {
+  if (World* world = World::GetCurrent())
+  {
+    return world->GetRegistry();
+  }
+  return Engine::Get().GetRegistry();
+}
+
+ThreadPool& System::GetThreadPool()
+{
+  return Engine::Get().GetThreadPool();
+}
+
+const SimulationClock& System::GetSimulationClock()
+{
+  if (World* world = World::GetCurrent())
+  {
+    return world->GetSimulationClock();
+  }
+  return Engine::Get().GetSimulationClock();
 }
 
 } // namespace tk
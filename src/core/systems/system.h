@@ -1,7 +1,13 @@
 #ifndef TECH_SYSTEM_H
 #define TECH_SYSTEM_H
 
+#include "core/ecs/change_tracker.h"
+#include "core/ecs/command_buffer.h"
 #include "core/ecs/registry.h"
+#include "core/simulation_clock.h"
+#include "core/threads/thread_pool.h"
+#include <optional>
+#include <tuple>
 
 namespace tk
 {
@@ -9,7 +15,15 @@ namespace tk
 class System
 {
 protected:
+  // Entities per chunk are kept a multiple of a cache line worth of entity ids
+  // and never drop below this, so small views run inline.
+  static constexpr u32 MinParallelGrain = 1024;
+  static constexpr u32 GrainAlignment = 64 / sizeof(entt::entity);
+  static constexpr u32 ChunksPerWorker = 4;
+
   static Registry& GetRegistry();
+  static ThreadPool& GetThreadPool();
+  static const SimulationClock& GetSimulationClock();
   static entt::entity CreateEntity()
   {
     return GetRegistry().create();
@@ -18,18 +32,141 @@ protected:
   {
     return GetRegistry().get<C>(entity);
   }
-  template <typename C> static void AddComponent(const entt::entity& entity, C& Component)
+  template <typename C> static void AddComponent(const entt::entity& entity, C&& component)
+  {
+    GetRegistry().emplace<std::decay_t<C>>(entity, std::forward<C>(component));
+  }
+
+  // Bulk versions for waves of spawns, built on entt's range create, insert
+  // and destroy. Storages grow once per call instead of once per entity.
+  // Creates count entities into outEntities, each with a copy of components.
+  template <typename... C>
+  static void CreateEntities(entt::entity* outEntities, u32 count, const C&... components)
+  {
+    Registry& registry = GetRegistry();
+    registry.create(outEntities, outEntities + count);
+    (AddComponents<C>(outEntities, count, components), ...);
+  }
+  // Gives every entity a copy of component.
+  template <typename C> static void AddComponents(const entt::entity* entities, u32 count, const C& component)
+  {
+    auto& storage = GetRegistry().storage<C>();
+    storage.reserve(storage.size() + count);
+    storage.insert(entities, entities + count, component);
+  }
+  // Gives entities[i] a copy of components[i].
+  template <typename C> static void AddComponents(const entt::entity* entities, u32 count, const C* components)
+  {
+    auto& storage = GetRegistry().storage<C>();
+    storage.reserve(storage.size() + count);
+    storage.insert(entities, entities + count, components);
+  }
+  static void DestroyEntities(const entt::entity* entities, u32 count)
   {
-    GetRegistry().emplace<C>(entity, Component);
+    GetRegistry().destroy(entities, entities + count);
   }
-  template <typename... C> static auto& GetView()
+  template <typename... C> static auto GetView()
   {
     return GetRegistry().view<C...>();
   }
+  template <typename C> static ChangeTracker& GetChanges()
+  {
+    return ComponentChanges<C>::Get(GetRegistry());
+  }
+  // Structural changes that can't be made while iterating or from another
+  // thread, recorded into the calling thread's buffer and played back after
+  // the current phase.
+  static CommandBuffer& GetCommands()
+  {
+    return CommandQueue::Get(GetRegistry()).GetLocal();
+  }
+
+  static u32 GetParallelGrain(u32 count)
+  {
+    u32 grain = count / (GetThreadPool().GetNumWorkers() * ChunksPerWorker);
+    grain = grain < MinParallelGrain ? MinParallelGrain : grain;
+    return (grain + GrainAlignment - 1) / GrainAlignment * GrainAlignment;
+  }
+
+  // Like View::each(func) with func(entity, C&...), but the view's leading
+  // storage is split into contiguous chunks that run on the thread pool.
+  // func must only touch the entity it is given. Structural changes go
+  // through func(commands, entity, C&...), the buffer is sorted by entity
+  // within the caller's sort key so playback order doesn't depend on how the
+  // chunks were scheduled. Without a CommandQueue in the registry context,
+  // like a registry the engine doesn't own, commands go to a queue of its own
+  // that every chunk shares, so it runs serially on the calling thread and
+  // plays that queue back at the end.
+  template <typename... C, typename Func> static void ParallelEach(Func&& func, u32 grainSize = 0)
+  {
+    auto view = GetView<C...>();
+    const auto* storage = view.handle();
+    if (!storage)
+    {
+      return;
+    }
+
+    constexpr bool bCommands = std::is_invocable_v<Func&, CommandBuffer&, entt::entity, C&...>;
+    CommandQueue* commands = GetRegistry().ctx().template find<CommandQueue>();
+    std::optional<CommandQueue> fallback;
+    if (bCommands && !commands)
+    {
+      commands = &fallback.emplace(0);
+    }
+
+    u64 baseKey = bCommands ? commands->GetLocal().GetSortKey() & ~(u64)0xffffffff : 0;
+    u32 count = (u32)storage->size();
+    const entt::entity* entities = storage->data();
+    auto each = [&view, &func, commands, baseKey, entities](u32 begin, u32 end) {
+      CommandBuffer* buffer = bCommands ? &commands->GetLocal() : nullptr;
+      u64 sortKey = bCommands ? buffer->GetSortKey() : 0;
+      for (u32 i = begin; i < end; i++)
+      {
+        entt::entity entity = entities[i];
+        if constexpr (sizeof...(C) > 1)
+        {
+          if (!view.contains(entity))
+          {
+            continue;
+          }
+        }
+        if constexpr (bCommands)
+        {
+          buffer->SetSortKey(baseKey | entt::to_integral(entity));
+          std::apply(func, std::tuple_cat(std::forward_as_tuple(*buffer, entity), view.get(entity)));
+        }
+        else
+        {
+          std::apply(func, std::tuple_cat(std::make_tuple(entity), view.get(entity)));
+        }
+      }
+      if constexpr (bCommands)
+      {
+        buffer->SetSortKey(sortKey);
+      }
+    };
+
+    if (fallback)
+    {
+      each(0, count);
+      fallback->Playback(GetRegistry());
+      return;
+    }
+    GetThreadPool().ParallelFor(count, grainSize ? grainSize : GetParallelGrain(count), each);
+  }
 
 public:
   virtual void Init() = 0;
   virtual void Shutdown() = 0;
+  // Bracket bulk rewrites of the registry, like loading a snapshot. Systems
+  // that mirror components stop following the registry hooks in Suspend and
+  // rebuild their mirror once in Resume.
+  virtual void Suspend()
+  {
+  }
+  virtual void Resume()
+  {
+  }
   virtual ~System() = default;
 };
 
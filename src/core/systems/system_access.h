@@ -0,0 +1,66 @@
+#ifndef TK_SYSTEM_ACCESS_H
+#define TK_SYSTEM_ACCESS_H
+
+#include "core/dynamic_array.h"
+#include "core/ecs/registry.h"
+#include <algorithm>
+
+namespace tk
+{
+
+// Component read/write set of a system. Two systems may run concurrently
+// only if neither writes a component the other reads or writes.
+class SystemAccess
+{
+  DynamicArray<entt::id_type> mReads = {};
+  DynamicArray<entt::id_type> mWrites = {};
+  bool bExclusive = true;
+
+public:
+  template <typename... C> SystemAccess& Read()
+  {
+    (mReads.push_back(entt::type_hash<C>::value()), ...);
+    bExclusive = false;
+    return *this;
+  }
+
+  template <typename... C> SystemAccess& Write()
+  {
+    (mWrites.push_back(entt::type_hash<C>::value()), ...);
+    bExclusive = false;
+    return *this;
+  }
+
+  // Systems that never declare their access conflict with everything.
+  SystemAccess& Exclusive()
+  {
+    bExclusive = true;
+    return *this;
+  }
+
+  bool IsExclusive() const
+  {
+    return bExclusive;
+  }
+
+  bool ConflictsWith(const SystemAccess& other) const
+  {
+    if (bExclusive || other.bExclusive)
+    {
+      return true;
+    }
+    return Intersects(mWrites, other.mWrites) || Intersects(mWrites, other.mReads) ||
+           Intersects(mReads, other.mWrites);
+  }
+
+private:
+  static bool Intersects(const DynamicArray<entt::id_type>& a, const DynamicArray<entt::id_type>& b)
+  {
+    return std::any_of(a.begin(), a.end(),
+                       [&b](entt::id_type id) { return std::find(b.begin(), b.end(), id) != b.end(); });
+  }
+};
+
+} // namespace tk
+
+#endif // !TK_SYSTEM_ACCESS_H
@@ -0,0 +1,191 @@
+#ifndef TK_SYSTEM_PIPELINE_H
+#define TK_SYSTEM_PIPELINE_H
+
+#include "core/enums/e_system_phase.h"
+#include "core/systems/system_access.h"
+#include "core/systems/system_profiler.h"
+#include "core/systems/system_scheduler.h"
+#include "core/types.h"
+#include <chrono>
+#include <tuple>
+#include <typeinfo>
+#include <utility>
+
+namespace tk
+{
+
+struct SystemPhaseTimings
+{
+  u64 Ns[(u32)ESystemPhase::NumPhases] = {};
+
+  u64 Get(ESystemPhase phase) const
+  {
+    return Ns[(u32)phase];
+  }
+};
+
+// Static list of systems, stored by value and run phase by phase. Every system
+// type declares its phase through a static Phase member, within a phase
+// systems run in the order they are listed. Calls are qualified with the
+// concrete type so the hot loop never goes through the vtable.
+//
+// Update phases whose systems' declared access lets some of them overlap run
+// through a SystemScheduler on the thread pool, with the same result as the
+// listed order. Phases where every system conflicts with the one before it
+// run inline.
+template <typename... Systems> class SystemPipeline
+{
+  static constexpr u32 NumUpdatePhases = (u32)ESystemPhase::Extract;
+
+  std::tuple<Systems...> mSystems = {};
+  SystemPhaseTimings mTimings = {};
+  SystemProfiler* mProfiler = nullptr;
+  u32 mProfileIds[sizeof...(Systems)] = {};
+  class ThreadPool* mPool = nullptr;
+  SystemScheduler mSchedulers[NumUpdatePhases] = {};
+  bool bScheduled[NumUpdatePhases] = {};
+
+public:
+  // Commands recorded by scheduled systems go to commands, sorted by the
+  // order the systems are listed in.
+  void Init(class ThreadPool& pool, class CommandQueue& commands)
+  {
+    std::apply([](Systems&... systems) { (systems.Init(), ...); }, mSystems);
+
+    mPool = &pool;
+    AddToSchedulers(std::index_sequence_for<Systems...>{});
+    for (u32 phase = 0; phase < NumUpdatePhases; phase++)
+    {
+      mSchedulers[phase].SetCommandQueue(&commands);
+      bScheduled[phase] = mSchedulers[phase].IsParallel();
+    }
+  }
+
+  void Shutdown()
+  {
+    std::apply([](Systems&... systems) { (systems.Shutdown(), ...); }, mSystems);
+  }
+
+  void Suspend()
+  {
+    std::apply([](Systems&... systems) { (systems.Systems::Suspend(), ...); }, mSystems);
+  }
+
+  void Resume()
+  {
+    std::apply([](Systems&... systems) { (systems.Systems::Resume(), ...); }, mSystems);
+  }
+
+  // Update phases take the delta time, Extract takes the render snapshot.
+  template <ESystemPhase Phase, typename... Args> void Run(Args&... args)
+  {
+    auto start = std::chrono::steady_clock::now();
+    if constexpr (Phase != ESystemPhase::Extract)
+    {
+      if (bScheduled[(u32)Phase])
+      {
+        mSchedulers[(u32)Phase].Run(*mPool, args...);
+      }
+      else
+      {
+        RunSystems<Phase>(std::index_sequence_for<Systems...>{}, args...);
+      }
+    }
+    else
+    {
+      RunSystems<Phase>(std::index_sequence_for<Systems...>{}, args...);
+    }
+    mTimings.Ns[(u32)Phase] +=
+        (u64)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+  }
+
+  // Times every Update call into profiler, nullptr to stop. Extract calls
+  // aren't part of the simulation frame and aren't timed.
+  void SetProfiler(SystemProfiler* profiler)
+  {
+    mProfiler = profiler;
+    u32 i = 0;
+    ((mProfileIds[i++] =
+          profiler && Systems::Phase != ESystemPhase::Extract ? profiler->Register(typeid(Systems)) : 0),
+     ...);
+  }
+
+  template <typename S> S& Get()
+  {
+    return std::get<S>(mSystems);
+  }
+
+  // Timings add up until reset, so a phase that runs several times in a frame
+  // reports its total.
+  const SystemPhaseTimings& GetTimings() const
+  {
+    return mTimings;
+  }
+
+  void ResetTimings()
+  {
+    mTimings = {};
+  }
+
+  // Whether the phase runs through the scheduler rather than inline.
+  bool IsScheduled(ESystemPhase phase) const
+  {
+    return phase != ESystemPhase::Extract && bScheduled[(u32)phase];
+  }
+
+private:
+  template <size_t... I> void AddToSchedulers(std::index_sequence<I...>)
+  {
+    (AddToScheduler<I>(), ...);
+  }
+
+  template <size_t I> void AddToScheduler()
+  {
+    using S = std::tuple_element_t<I, std::tuple<Systems...>>;
+    if constexpr (S::Phase != ESystemPhase::Extract)
+    {
+      SystemAccess access;
+      std::get<I>(mSystems).S::DeclareAccess(access);
+      mSchedulers[(u32)S::Phase].Add(&SystemPipeline::UpdateSystem<I>, this, access);
+    }
+  }
+
+  template <size_t I> static void UpdateSystem(void* pipeline, f32 deltaTime)
+  {
+    using S = std::tuple_element_t<I, std::tuple<Systems...>>;
+    SystemPipeline& self = *static_cast<SystemPipeline*>(pipeline);
+    self.template RunSystem<S::Phase, I>(std::get<I>(self.mSystems), deltaTime);
+  }
+
+  template <ESystemPhase Phase, size_t... I, typename... Args> void RunSystems(std::index_sequence<I...>, Args&... args)
+  {
+    (RunSystem<Phase, I>(std::get<I>(mSystems), args...), ...);
+  }
+
+  template <ESystemPhase Phase, size_t I, typename S, typename... Args> void RunSystem(S& system, Args&... args)
+  {
+    if constexpr (S::Phase == Phase)
+    {
+      if constexpr (Phase == ESystemPhase::Extract)
+      {
+        system.S::Extract(args...);
+      }
+      else if (mProfiler)
+      {
+        auto start = std::chrono::steady_clock::now();
+        system.S::Update(args...);
+        mProfiler->Add(mProfileIds[I], (u64)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                           std::chrono::steady_clock::now() - start)
+                                           .count());
+      }
+      else
+      {
+        system.S::Update(args...);
+      }
+    }
+  }
+};
+
+} // namespace tk
+
+#endif // !TK_SYSTEM_PIPELINE_H
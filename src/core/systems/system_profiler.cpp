@@ -0,0 +1,132 @@
+#include "system_profiler.h"
+#include "core/logger.h"
+#include <algorithm>
+#include <fstream>
+
+#ifdef __GNUG__
+#include <cstdlib>
+#include <cxxabi.h>
+#endif
+
+namespace tk
+{
+
+static constexpr f64 NsToMs = 1e-6;
+
+SystemProfiler::~SystemProfiler()
+{
+  Clear();
+}
+
+u32 SystemProfiler::Register(std::string_view name)
+{
+  Entry* entry = new Entry();
+  entry->Name = name;
+  mEntries.push_back(entry);
+  return (u32)mEntries.size() - 1;
+}
+
+u32 SystemProfiler::Register(const std::type_info& type)
+{
+  std::string name = type.name();
+#ifdef __GNUG__
+  int status = 0;
+  if (char* demangled = abi::__cxa_demangle(type.name(), nullptr, nullptr, &status))
+  {
+    name = demangled;
+    std::free(demangled);
+  }
+#endif
+  // Drop MSVC's "class " prefix and the engine namespace.
+  std::string_view view = name;
+  for (std::string_view prefix : {"class ", "struct ", "tk::"})
+  {
+    if (view.starts_with(prefix))
+    {
+      view.remove_prefix(prefix.size());
+    }
+  }
+  return Register(view);
+}
+
+void SystemProfiler::EndFrame()
+{
+  for (Entry* entry : mEntries)
+  {
+    if (!entry->bRan)
+    {
+      continue;
+    }
+    entry->Samples[entry->Next] = entry->FrameNs;
+    entry->Next = (entry->Next + 1) % WindowSize;
+    entry->Count = std::min(entry->Count + 1, WindowSize);
+    entry->FrameNs = 0;
+    entry->bRan = false;
+  }
+}
+
+void SystemProfiler::Clear()
+{
+  for (Entry* entry : mEntries)
+  {
+    delete entry;
+  }
+  mEntries.clear();
+}
+
+void SystemProfiler::GetStats(DynamicArray<SystemTimingStats>& out) const
+{
+  out.resize(mEntries.size());
+  u64 sorted[WindowSize];
+  for (size_t i = 0; i < mEntries.size(); i++)
+  {
+    const Entry& entry = *mEntries[i];
+    SystemTimingStats& stats = out[i];
+    stats.Name = entry.Name;
+    stats.Samples = entry.Count;
+    if (entry.Count == 0)
+    {
+      stats.LastMs = stats.MinMs = stats.AvgMs = stats.P99Ms = 0.0;
+      continue;
+    }
+
+    // Until the window is full the samples are the first Count entries.
+    std::copy(entry.Samples, entry.Samples + entry.Count, sorted);
+    u64 total = 0;
+    u64 min = sorted[0];
+    for (u32 s = 0; s < entry.Count; s++)
+    {
+      total += sorted[s];
+      min = std::min(min, sorted[s]);
+    }
+    u32 p99 = (entry.Count * 99 + 99) / 100 - 1;
+    std::nth_element(sorted, sorted + p99, sorted + entry.Count);
+
+    stats.LastMs = (f64)entry.Samples[(entry.Next + WindowSize - 1) % WindowSize] * NsToMs;
+    stats.MinMs = (f64)min * NsToMs;
+    stats.AvgMs = (f64)total / entry.Count * NsToMs;
+    stats.P99Ms = (f64)sorted[p99] * NsToMs;
+  }
+}
+
+bool SystemProfiler::WriteCsv(const std::string& path) const
+{
+  std::ofstream file(path);
+  if (!file.is_open())
+  {
+    Logger::Error("Failed to open {}", path);
+    return false;
+  }
+
+  DynamicArray<SystemTimingStats> stats;
+  GetStats(stats);
+  file << "system,samples,last_ms,min_ms,avg_ms,p99_ms\n";
+  for (const SystemTimingStats& system : stats)
+  {
+    file << system.Name << ',' << system.Samples << ',' << system.LastMs << ',' << system.MinMs << ','
+         << system.AvgMs << ',' << system.P99Ms << '\n';
+  }
+  return file.good();
+}
+
+} // namespace tk
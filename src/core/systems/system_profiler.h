@@ -0,0 +1,88 @@
+#ifndef TK_SYSTEM_PROFILER_H
+#define TK_SYSTEM_PROFILER_H
+
+#include "core/dynamic_array.h"
+#include "core/types.h"
+#include <string>
+#include <string_view>
+#include <typeinfo>
+
+namespace tk
+{
+
+struct SystemProfilerConfig
+{
+  bool bEnabled = true;
+  // Written when the engine shuts down, empty to skip. Set it from
+  // Engine::ConfigureProfiler to opt in.
+  std::string CsvPath = {};
+};
+
+// Per frame CPU time of one system over the profiler's window, in
+// milliseconds. Frames where the system didn't run aren't counted.
+struct SystemTimingStats
+{
+  std::string Name = {};
+  u32 Samples = 0;
+  f64 LastMs = 0.0;
+  f64 MinMs = 0.0;
+  f64 AvgMs = 0.0;
+  f64 P99Ms = 0.0;
+};
+
+// Rolling CPU time per system. Every call adds to the system's time for the
+// current frame, EndFrame turns it into a sample. Systems are registered on
+// the game thread, after that each one may be timed from any thread as long
+// as the same system isn't timed from two threads at once.
+class SystemProfiler
+{
+public:
+  static constexpr u32 WindowSize = 256;
+
+private:
+  struct Entry
+  {
+    std::string Name = {};
+    u64 FrameNs = 0;
+    bool bRan = false;
+    u32 Next = 0;
+    u32 Count = 0;
+    u64 Samples[WindowSize] = {};
+  };
+
+  DynamicArray<Entry*> mEntries = {};
+
+public:
+  SystemProfiler() = default;
+  ~SystemProfiler();
+
+  SystemProfiler(const SystemProfiler&) = delete;
+  SystemProfiler& operator=(const SystemProfiler&) = delete;
+
+  // Returns the id to time the system with.
+  u32 Register(std::string_view name);
+  u32 Register(const std::type_info& type);
+
+  void Add(u32 id, u64 ns)
+  {
+    Entry& entry = *mEntries[id];
+    entry.FrameNs += ns;
+    entry.bRan = true;
+  }
+
+  void EndFrame();
+  void Clear();
+
+  u32 GetNumSystems() const
+  {
+    return (u32)mEntries.size();
+  }
+
+  // out keeps its memory between calls, one element per system.
+  void GetStats(DynamicArray<SystemTimingStats>& out) const;
+  bool WriteCsv(const std::string& path) const;
+};
+
+} // namespace tk
+
+#endif // !TK_SYSTEM_PROFILER_H
@@ -0,0 +1,154 @@
+#include "system_scheduler.h"
+#include "core/ecs/command_buffer.h"
+#include "core/systems/system_profiler.h"
+#include "core/systems/update/update_system.h"
+#include "core/threads/thread_pool.h"
+#include "core/world.h"
+#include <chrono>
+#include <typeinfo>
+
+namespace tk
+{
+
+void SystemScheduler::SetCommandQueue(CommandQueue* commands)
+{
+  mCommands = commands;
+}
+
+void SystemScheduler::SetProfiler(SystemProfiler* profiler)
+{
+  mProfiler = profiler;
+}
+
+void SystemScheduler::Add(SUpdate* system)
+{
+  Node node{[](void* context, f32 deltaTime) { static_cast<SUpdate*>(context)->Update(deltaTime); },
+            system,
+            {},
+            {},
+            0,
+            mProfiler ? mProfiler->Register(typeid(*system)) : NoProfileId};
+  system->DeclareAccess(node.Access);
+  mNodes.emplace_back(std::move(node));
+  bDirty = true;
+}
+
+void SystemScheduler::Add(UpdateFunc update, void* context, const SystemAccess& access)
+{
+  mNodes.push_back({update, context, access, {}, 0, NoProfileId});
+  bDirty = true;
+}
+
+void SystemScheduler::Clear()
+{
+  mNodes.clear();
+  mRoots.clear();
+  mPending.reset();
+  bDirty = true;
+}
+
+void SystemScheduler::Build()
+{
+  mRoots.clear();
+  for (Node& node : mNodes)
+  {
+    node.Dependents.clear();
+    node.NumDependencies = 0;
+  }
+
+  // Depending on the previous system for every system means one chain.
+  bParallel = false;
+  for (u32 i = 0; i < mNodes.size(); i++)
+  {
+    for (u32 j = 0; j < i; j++)
+    {
+      if (mNodes[i].Access.ConflictsWith(mNodes[j].Access))
+      {
+        mNodes[j].Dependents.push_back(i);
+        mNodes[i].NumDependencies++;
+      }
+    }
+    if (mNodes[i].NumDependencies == 0)
+    {
+      mRoots.push_back(i);
+    }
+    bParallel = bParallel || (i > 0 && !mNodes[i].Access.ConflictsWith(mNodes[i - 1].Access));
+  }
+
+  mPending.reset(new std::atomic<u32>[mNodes.size()]);
+  bDirty = false;
+}
+
+bool SystemScheduler::IsParallel()
+{
+  if (bDirty)
+  {
+    Build();
+  }
+  return bParallel;
+}
+
+void SystemScheduler::Run(ThreadPool& pool, f32 deltaTime)
+{
+  if (bDirty)
+  {
+    Build();
+  }
+
+  for (u32 i = 0; i < mNodes.size(); i++)
+  {
+    mPending[i].store(mNodes[i].NumDependencies, std::memory_order_relaxed);
+  }
+
+  JobCounter counter;
+  World* world = World::GetCurrent();
+  for (u32 root : mRoots)
+  {
+    Dispatch(pool, counter, world, root, deltaTime);
+  }
+  pool.Wait(counter);
+}
+
+void SystemScheduler::Dispatch(ThreadPool& pool, JobCounter& counter, World* world, u32 index, f32 deltaTime)
+{
+  pool.Submit(
+      [this, &pool, &counter, world, index, deltaTime]() {
+        World::Scope scope(world);
+        Node& node = mNodes[index];
+        CommandBuffer* commands = mCommands ? &mCommands->GetLocal() : nullptr;
+        u64 sortKey = commands ? commands->GetSortKey() : 0;
+        if (commands)
+        {
+          commands->SetSortKey((u64)(index + 1) << 32);
+        }
+
+        if (mProfiler && node.ProfileId != NoProfileId)
+        {
+          auto start = std::chrono::steady_clock::now();
+          node.Update(node.Context, deltaTime);
+          mProfiler->Add(node.ProfileId, (u64)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                             std::chrono::steady_clock::now() - start)
+                                             .count());
+        }
+        else
+        {
+          node.Update(node.Context, deltaTime);
+        }
+
+        if (commands)
+        {
+          commands->SetSortKey(sortKey);
+        }
+
+        for (u32 dependent : node.Dependents)
+        {
+          if (mPending[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1)
+          {
+            Dispatch(pool, counter, world, dependent, deltaTime);
+          }
+        }
+      },
+      counter);
+}
+
+} // namespace tk
@@ -0,0 +1,74 @@
+#ifndef TK_SYSTEM_SCHEDULER_H
+#define TK_SYSTEM_SCHEDULER_H
+
+#include "core/dynamic_array.h"
+#include "core/systems/system_access.h"
+#include <atomic>
+#include <memory>
+
+namespace tk
+{
+
+// Runs update systems on the thread pool. A system depends on every earlier
+// registered system whose access conflicts with its own, so the result is the
+// same as running them serially in registration order. Systems run within the
+// world that was current when Run was called.
+class SystemScheduler
+{
+public:
+  // Runs the system behind context, for callers that know its type and call
+  // it without the vtable.
+  using UpdateFunc = void (*)(void* context, f32 deltaTime);
+
+private:
+  static constexpr u32 NoProfileId = ~0u;
+
+  struct Node
+  {
+    UpdateFunc Update;
+    void* Context;
+    SystemAccess Access;
+    DynamicArray<u32> Dependents;
+    u32 NumDependencies;
+    u32 ProfileId;
+  };
+
+  DynamicArray<Node> mNodes = {};
+  DynamicArray<u32> mRoots = {};
+  std::unique_ptr<std::atomic<u32>[]> mPending;
+  class SystemProfiler* mProfiler = nullptr;
+  class CommandQueue* mCommands = nullptr;
+  bool bParallel = false;
+  bool bDirty = true;
+
+public:
+  // Commands a system records outside ParallelEach are sorted by the order
+  // systems were added in, wherever they ran.
+  void SetCommandQueue(class CommandQueue* commands);
+  // Times the Update calls of systems added from now on, nullptr to stop
+  // timing all of them.
+  void SetProfiler(class SystemProfiler* profiler);
+  void Add(class SUpdate* system);
+  // Adds a system that update runs, with the access it declared. Not timed
+  // here, update is expected to time it if needed.
+  void Add(UpdateFunc update, void* context, const SystemAccess& access);
+  void Clear();
+  void Run(class ThreadPool& pool, f32 deltaTime);
+
+  u32 Size() const
+  {
+    return (u32)mNodes.size();
+  }
+
+  // Whether any two systems may run at the same time. When every system
+  // conflicts with the one added before it, Run is just a slower serial loop.
+  bool IsParallel();
+
+private:
+  void Build();
+  void Dispatch(class ThreadPool& pool, class JobCounter& counter, class World* world, u32 index, f32 deltaTime);
+};
+
+} // namespace tk
+
+#endif // !TK_SYSTEM_SCHEDULER_H
@@ -0,0 +1,105 @@
+#include "s_hierarchy.h"
+
+namespace tk
+{
+
+void SHierarchy::Init()
+{
+  Registry& registry = GetRegistry();
+  registry.on_construct<CParent>().connect<&SHierarchy::OnLinkChange>(*this);
+  registry.on_update<CParent>().connect<&SHierarchy::OnLinkChange>(*this);
+  registry.on_destroy<CParent>().connect<&SHierarchy::OnLinkChange>(*this);
+  registry.on_destroy<CLocalTransform>().connect<&SHierarchy::OnNodeChange>(*this);
+  registry.on_construct<CTransform>().connect<&SHierarchy::OnNodeChange>(*this);
+  registry.on_destroy<CTransform>().connect<&SHierarchy::OnNodeChange>(*this);
+  bDirty = true;
+}
+
+void SHierarchy::Shutdown()
+{
+  Registry& registry = GetRegistry();
+  registry.on_construct<CParent>().disconnect(this);
+  registry.on_update<CParent>().disconnect(this);
+  registry.on_destroy<CParent>().disconnect(this);
+  registry.on_destroy<CLocalTransform>().disconnect(this);
+  registry.on_construct<CTransform>().disconnect(this);
+  registry.on_destroy<CTransform>().disconnect(this);
+  mHierarchy.Clear();
+}
+
+// Resume marks the hierarchy dirty, the next update rebuilds it once.
+void SHierarchy::Suspend()
+{
+  Shutdown();
+}
+
+void SHierarchy::Resume()
+{
+  Init();
+}
+
+void SHierarchy::Update(f32 dt)
+{
+  Registry& registry = GetRegistry();
+  bool bRebuilt = bDirty;
+  if (bDirty)
+  {
+    mHierarchy.Build(registry);
+    bDirty = false;
+  }
+
+  auto& locals = registry.storage<CLocalTransform>();
+  bool bValid = GetChanges<CLocalTransform>().Consume(mLastTick, [&](entt::entity entity) {
+    if (locals.contains(entity))
+    {
+      mHierarchy.SetLocal(entity, locals.get(entity));
+    }
+  });
+  if (!bValid && !bRebuilt)
+  {
+    mHierarchy.ReadLocals(registry);
+  }
+
+  u32 numLevels = mHierarchy.GetNumLevels();
+  if (numLevels == 0)
+  {
+    return;
+  }
+
+  ThreadPool& pool = GetThreadPool();
+  u32 numRoots = mHierarchy.LevelEnd(0);
+  pool.ParallelFor(numRoots, GetParallelGrain(numRoots), [this, &registry](u32 begin, u32 end) {
+    mHierarchy.GatherRoots(registry, begin, end);
+  });
+
+  // Each level reads the one above it, so levels run one after another.
+  for (u32 level = 1; level < numLevels; level++)
+  {
+    u32 first = mHierarchy.LevelBegin(level);
+    u32 count = mHierarchy.LevelEnd(level) - first;
+    pool.ParallelFor(count, GetParallelGrain(count), [this, &registry, first](u32 begin, u32 end) {
+      mHierarchy.Propagate(registry, first + begin, first + end);
+    });
+  }
+
+  // Propagate bypasses the update signal.
+  ChangeTracker& changes = GetChanges<CTransform>();
+  mHierarchy.ForEachMoved([&changes](entt::entity entity) { changes.MarkChanged(entity); });
+}
+
+void SHierarchy::DeclareAccess(SystemAccess& access) const
+{
+  access.Read<CParent, CLocalTransform>().Write<CTransform, ComponentChanges<CTransform>, ComponentChanges<CLocalTransform>>();
+}
+
+void SHierarchy::OnLinkChange(Registry& registry, entt::entity entity)
+{
+  bDirty = true;
+}
+
+void SHierarchy::OnNodeChange(Registry& registry, entt::entity entity)
+{
+  bDirty = bDirty || mHierarchy.Contains(entity);
+}
+
+} // namespace tk
@@ -0,0 +1,44 @@
+#ifndef TKS_HIERARCHY_H
+#define TKS_HIERARCHY_H
+
+#include "core/ecs/transform_hierarchy.h"
+#include "update_system.h"
+
+namespace tk
+{
+
+// Moves entities with a CParent along with their parent. The tree is kept
+// flattened in a TransformHierarchy, rebuilt only when a CParent changes, and
+// each step is propagated one level at a time with every level split across
+// the thread pool. Children are moved through CLocalTransform, their
+// CTransform is reset to their world transform every step and marked changed,
+// so SIntegrate reloads it instead of reverting it.
+class SHierarchy final : public SUpdate
+{
+  TransformHierarchy mHierarchy = {};
+  u32 mLastTick = ChangeTracker::NeverTick;
+  bool bDirty = true;
+
+public:
+  static constexpr ESystemPhase Phase = ESystemPhase::FixedUpdate;
+
+  virtual void Init() override;
+  virtual void Shutdown() override;
+  virtual void Suspend() override;
+  virtual void Resume() override;
+  virtual void Update(f32 dt) override;
+  virtual void DeclareAccess(SystemAccess& access) const override;
+
+  const TransformHierarchy& GetHierarchy() const
+  {
+    return mHierarchy;
+  }
+
+private:
+  void OnLinkChange(Registry& registry, entt::entity entity);
+  void OnNodeChange(Registry& registry, entt::entity entity);
+};
+
+} // namespace tk
+
+#endif // !TKS_HIERARCHY_H
@@ -0,0 +1,100 @@
+#include "s_integrate.h"
+
+namespace tk
+{
+
+void SIntegrate::Init()
+{
+  Registry& registry = GetRegistry();
+  registry.on_construct<CTransform>().connect<&SIntegrate::OnConstruct>(*this);
+  registry.on_construct<CVelocity>().connect<&SIntegrate::OnConstruct>(*this);
+  registry.on_destroy<CTransform>().connect<&SIntegrate::OnDestroy>(*this);
+  registry.on_destroy<CVelocity>().connect<&SIntegrate::OnDestroy>(*this);
+  registry.on_update<CVelocity>().connect<&SIntegrate::OnVelocityUpdate>(*this);
+
+  auto view = registry.view<CTransform, CVelocity>();
+  for (auto [entity, transform, velocity] : view.each())
+  {
+    mTransforms.Add(entity, transform, velocity);
+  }
+}
+
+void SIntegrate::Shutdown()
+{
+  Registry& registry = GetRegistry();
+  registry.on_construct<CTransform>().disconnect(this);
+  registry.on_construct<CVelocity>().disconnect(this);
+  registry.on_destroy<CTransform>().disconnect(this);
+  registry.on_destroy<CVelocity>().disconnect(this);
+  registry.on_update<CVelocity>().disconnect(this);
+  mTransforms.Clear();
+  mLastTick = ChangeTracker::NeverTick;
+}
+
+// The mirror is dropped while suspended and refilled in one pass.
+void SIntegrate::Suspend()
+{
+  Shutdown();
+}
+
+void SIntegrate::Resume()
+{
+  Init();
+
+  // Already read from the registry, skip the full pass the resumed tracker
+  // would ask for.
+  mLastTick = GetChanges<CTransform>().Advance();
+}
+
+void SIntegrate::Update(f32 dt)
+{
+  Registry& registry = GetRegistry();
+  ChangeTracker& changes = GetChanges<CTransform>();
+  auto& transforms = registry.storage<CTransform>();
+  bool bValid = changes.Consume(mLastTick, [this, &transforms](entt::entity entity) {
+    if (transforms.contains(entity))
+    {
+      mTransforms.SetTransform(entity, transforms.get(entity));
+    }
+  });
+  if (!bValid)
+  {
+    mTransforms.ReadTransforms(registry);
+  }
+
+  u32 count = mTransforms.Size();
+  GetThreadPool().ParallelFor(count, GetParallelGrain(count), [this, &registry, dt](u32 begin, u32 end) {
+    mTransforms.Integrate(begin, end, dt);
+    mTransforms.WriteBack(registry, begin, end);
+  });
+
+  // WriteBack bypasses the update signal. The mirror already holds these
+  // values, so the next step skips past its own marks.
+  changes.MarkChanged(mTransforms.GetEntities(), count);
+  mLastTick = changes.Advance();
+}
+
+void SIntegrate::DeclareAccess(SystemAccess& access) const
+{
+  access.Read<CVelocity>().Write<CTransform, ComponentChanges<CTransform>>();
+}
+
+void SIntegrate::OnConstruct(Registry& registry, entt::entity entity)
+{
+  if (const auto [transform, velocity] = registry.try_get<CTransform, CVelocity>(entity); transform && velocity)
+  {
+    mTransforms.Add(entity, *transform, *velocity);
+  }
+}
+
+void SIntegrate::OnDestroy(Registry& registry, entt::entity entity)
+{
+  mTransforms.Remove(entity);
+}
+
+void SIntegrate::OnVelocityUpdate(Registry& registry, entt::entity entity)
+{
+  mTransforms.SetVelocity(entity, registry.get<CVelocity>(entity));
+}
+
+} // namespace tk
@@ -0,0 +1,44 @@
+#ifndef TKS_INTEGRATE_H
+#define TKS_INTEGRATE_H
+
+#include "core/ecs/transform_soa.h"
+#include "update_system.h"
+
+namespace tk
+{
+
+// Moves every entity with a CTransform and a CVelocity. Their hot data is
+// mirrored into a TransformSoA through registry hooks, integrated with the
+// SIMD kernels and written back to CTransform once per step. CTransform stays
+// the source of truth: rows marked changed since the last step are reloaded
+// before integrating, so writes made in place must be marked in the
+// CTransform ChangeTracker like any other in-place write.
+class SIntegrate final : public SUpdate
+{
+  TransformSoA mTransforms = {};
+  u32 mLastTick = ChangeTracker::NeverTick;
+
+public:
+  static constexpr ESystemPhase Phase = ESystemPhase::FixedUpdate;
+
+  virtual void Init() override;
+  virtual void Shutdown() override;
+  virtual void Suspend() override;
+  virtual void Resume() override;
+  virtual void Update(f32 dt) override;
+  virtual void DeclareAccess(SystemAccess& access) const override;
+
+  const TransformSoA& GetTransforms() const
+  {
+    return mTransforms;
+  }
+
+private:
+  void OnConstruct(Registry& registry, entt::entity entity);
+  void OnDestroy(Registry& registry, entt::entity entity);
+  void OnVelocityUpdate(Registry& registry, entt::entity entity);
+};
+
+} // namespace tk
+
+#endif // !TKS_INTEGRATE_H
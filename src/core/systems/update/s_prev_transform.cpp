@@ -0,0 +1,87 @@
+#include "s_prev_transform.h"
+#include "core/components/c_prev_transform.h"
+#include "core/components/c_transform2d.h"
+
+namespace tk
+{
+
+void SPrevTransform::Init()
+{
+  GetRegistry().on_construct<CTransform>().connect<&SPrevTransform::OnConstruct>();
+  GetRegistry().on_destroy<CTransform>().connect<&SPrevTransform::OnDestroy>();
+}
+
+void SPrevTransform::Shutdown()
+{
+  GetRegistry().on_construct<CTransform>().disconnect<&SPrevTransform::OnConstruct>();
+  GetRegistry().on_destroy<CTransform>().disconnect<&SPrevTransform::OnDestroy>();
+}
+
+void SPrevTransform::Suspend()
+{
+  Shutdown();
+}
+
+void SPrevTransform::Resume()
+{
+  Init();
+
+  // Transforms added or removed while suspended still need their copy added
+  // or dropped.
+  Registry& registry = GetRegistry();
+  auto missing = registry.view<CTransform>(entt::exclude<CPrevTransform>);
+  DynamicArray<entt::entity> entities(missing.begin(), missing.end());
+  for (entt::entity entity : entities)
+  {
+    OnConstruct(registry, entity);
+  }
+
+  auto orphans = registry.view<CPrevTransform>(entt::exclude<CTransform>);
+  entities.assign(orphans.begin(), orphans.end());
+  registry.remove<CPrevTransform>(entities.begin(), entities.end());
+}
+
+void SPrevTransform::Update(f32 dt)
+{
+  Registry& registry = GetRegistry();
+  auto& transforms = registry.storage<CTransform>();
+  auto& prevs = registry.storage<CPrevTransform>();
+  ChangeTracker& prevChanges = GetChanges<CPrevTransform>();
+
+  bool bValid = GetChanges<CTransform>().Consume(mLastTick, [&](entt::entity entity) {
+    if (transforms.contains(entity) && prevs.contains(entity))
+    {
+      const CTransform& transform = transforms.get(entity);
+      prevs.get(entity) = {transform.Position, transform.Rotation, transform.Scale};
+      prevChanges.MarkChanged(entity);
+    }
+  });
+
+  if (!bValid)
+  {
+    ParallelEach<CTransform, CPrevTransform>(
+        [](entt::entity, const CTransform& transform, CPrevTransform& prev) {
+          prev = {transform.Position, transform.Rotation, transform.Scale};
+        });
+    prevChanges.MarkAllChanged();
+  }
+}
+
+void SPrevTransform::DeclareAccess(SystemAccess& access) const
+{
+  // Consuming the CTransform changes advances their tracker.
+  access.Read<CTransform>().Write<CPrevTransform, ComponentChanges<CTransform>>();
+}
+
+void SPrevTransform::OnConstruct(Registry& registry, entt::entity entity)
+{
+  const CTransform& transform = registry.get<CTransform>(entity);
+  registry.emplace_or_replace<CPrevTransform>(entity, transform.Position, transform.Rotation, transform.Scale);
+}
+
+void SPrevTransform::OnDestroy(Registry& registry, entt::entity entity)
+{
+  registry.remove<CPrevTransform>(entity);
+}
+
+} // namespace tk
@@ -0,0 +1,33 @@
+#ifndef TKS_PREV_TRANSFORM_H
+#define TKS_PREV_TRANSFORM_H
+
+#include "update_system.h"
+
+namespace tk
+{
+
+// Runs first in every fixed step and saves CTransform into CPrevTransform.
+// Only transforms changed since the last step differ from their copy, so only
+// those are copied.
+class SPrevTransform final : public SUpdate
+{
+  u32 mLastTick = ChangeTracker::NeverTick;
+
+public:
+  static constexpr ESystemPhase Phase = ESystemPhase::FixedUpdate;
+
+  virtual void Init() override;
+  virtual void Shutdown() override;
+  virtual void Suspend() override;
+  virtual void Resume() override;
+  virtual void Update(f32 dt) override;
+  virtual void DeclareAccess(SystemAccess& access) const override;
+
+private:
+  static void OnConstruct(Registry& registry, entt::entity entity);
+  static void OnDestroy(Registry& registry, entt::entity entity);
+};
+
+} // namespace tk
+
+#endif // !TKS_PREV_TRANSFORM_H
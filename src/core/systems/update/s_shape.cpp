@@ -5,8 +5,21 @@
 namespace tk
 {
 
+void SShape::Init()
+{
+}
+
+void SShape::Shutdown()
+{
+}
+
 void SShape::Update(f32 dt)
 {
 }
 
+void SShape::DeclareAccess(SystemAccess& access) const
+{
+  access.Read<CShape>().Write<CTransform>();
+}
+
 } // namespace tk
@@ -6,10 +6,15 @@
 namespace tk
 {
 
-class SShape : public SUpdate
+class SShape final : public SUpdate
 {
 public:
+  static constexpr ESystemPhase Phase = ESystemPhase::FixedUpdate;
+
+  virtual void Init() override;
+  virtual void Shutdown() override;
   virtual void Update(f32 dt) override;
+  virtual void DeclareAccess(SystemAccess& access) const override;
 };
 
 } // namespace tk
@@ -0,0 +1,81 @@
+#include "s_spatial_grid.h"
+#include "core/components/c_transform2d.h"
+
+namespace tk
+{
+
+void SSpatialGrid::Init()
+{
+  GetRegistry().ctx().emplace<SpatialGrid>();
+  Resume();
+}
+
+void SSpatialGrid::Shutdown()
+{
+  Suspend();
+  GetRegistry().ctx().erase<SpatialGrid>();
+}
+
+// The grid stays in the context while suspended, so references to it remain
+// valid, and is refilled from scratch on resume.
+void SSpatialGrid::Suspend()
+{
+  Registry& registry = GetRegistry();
+  registry.on_construct<CTransform>().disconnect<&SSpatialGrid::OnConstruct>();
+  registry.on_destroy<CTransform>().disconnect<&SSpatialGrid::OnDestroy>();
+}
+
+void SSpatialGrid::Resume()
+{
+  Registry& registry = GetRegistry();
+  SpatialGrid& grid = registry.ctx().get<SpatialGrid>();
+  registry.on_construct<CTransform>().connect<&SSpatialGrid::OnConstruct>();
+  registry.on_destroy<CTransform>().connect<&SSpatialGrid::OnDestroy>();
+
+  grid.Clear();
+  for (auto [entity, transform] : registry.view<CTransform>().each())
+  {
+    grid.Set(entity, transform.Position);
+  }
+  mLastTick = GetChanges<CTransform>().Advance();
+}
+
+void SSpatialGrid::Update(f32 dt)
+{
+  Registry& registry = GetRegistry();
+  SpatialGrid& grid = registry.ctx().get<SpatialGrid>();
+  auto& transforms = registry.storage<CTransform>();
+
+  bool bValid = GetChanges<CTransform>().Consume(mLastTick, [&](entt::entity entity) {
+    if (transforms.contains(entity))
+    {
+      grid.Set(entity, transforms.get(entity).Position);
+    }
+  });
+
+  if (!bValid)
+  {
+    for (auto [entity, transform] : transforms.each())
+    {
+      grid.Set(entity, transform.Position);
+    }
+  }
+}
+
+void SSpatialGrid::DeclareAccess(SystemAccess& access) const
+{
+  // Consuming the CTransform changes advances their tracker.
+  access.Read<CTransform>().Write<SpatialGrid, ComponentChanges<CTransform>>();
+}
+
+void SSpatialGrid::OnConstruct(Registry& registry, entt::entity entity)
+{
+  registry.ctx().get<SpatialGrid>().Set(entity, registry.get<CTransform>(entity).Position);
+}
+
+void SSpatialGrid::OnDestroy(Registry& registry, entt::entity entity)
+{
+  registry.ctx().get<SpatialGrid>().Remove(entity);
+}
+
+} // namespace tk
@@ -0,0 +1,35 @@
+#ifndef TKS_SPATIAL_GRID_H
+#define TKS_SPATIAL_GRID_H
+
+#include "core/ecs/spatial_grid.h"
+#include "update_system.h"
+
+namespace tk
+{
+
+// Keeps a SpatialGrid of every CTransform position in the registry context.
+// Runs at the end of the fixed step, once positions are final, and only
+// moves the entities whose CTransform changed. Systems that query the grid
+// get it with registry.ctx().get<SpatialGrid>() and declare Read<SpatialGrid>.
+class SSpatialGrid final : public SUpdate
+{
+  u32 mLastTick = ChangeTracker::NeverTick;
+
+public:
+  static constexpr ESystemPhase Phase = ESystemPhase::FixedUpdate;
+
+  virtual void Init() override;
+  virtual void Shutdown() override;
+  virtual void Suspend() override;
+  virtual void Resume() override;
+  virtual void Update(f32 dt) override;
+  virtual void DeclareAccess(SystemAccess& access) const override;
+
+private:
+  static void OnConstruct(Registry& registry, entt::entity entity);
+  static void OnDestroy(Registry& registry, entt::entity entity);
+};
+
+} // namespace tk
+
+#endif // !TKS_SPATIAL_GRID_H
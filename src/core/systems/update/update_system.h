@@ -2,15 +2,24 @@
 #define TECH_S_UPDATE_H
 
 #include "../system.h"
+#include "../system_access.h"
+#include "core/enums/e_system_phase.h"
 #include "core/types.h"
 
 namespace tk
 {
 
+// Update systems run in the Update phase unless they redeclare Phase.
 class SUpdate : public System
 {
 public:
+  static constexpr ESystemPhase Phase = ESystemPhase::Update;
+
   virtual void Update(f32 deltaTime) = 0;
+  virtual void DeclareAccess(SystemAccess& access) const
+  {
+    access.Exclusive();
+  }
 };
 
 } // namespace tk
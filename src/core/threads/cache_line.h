@@ -0,0 +1,13 @@
+#ifndef TK_CACHE_LINE_H
+#define TK_CACHE_LINE_H
+
+#include "core/types.h"
+
+namespace tk
+{
+
+inline constexpr u32 CacheLineSize = 64;
+
+} // namespace tk
+
+#endif // !TK_CACHE_LINE_H
@@ -0,0 +1,163 @@
+#ifndef TK_JOB_H
+#define TK_JOB_H
+
+#include "core/types.h"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace tk
+{
+
+using Job = std::function<void()>;
+
+// Counts outstanding jobs. Waiters park on the counter itself (futex-backed
+// std::atomic::wait) instead of spinning. A counter reads as zero only once
+// the last Decrement stopped touching it, so waiters may keep it on the stack.
+class JobCounter
+{
+  std::atomic<u32> mCount = 0;
+  // Decrements between their first and last access to the counter.
+  std::atomic<u32> mDecrementing = 0;
+  std::atomic<bool> bHasContinuations = false;
+  std::mutex mContinuationsMutex;
+  std::vector<Job> mContinuations = {};
+
+public:
+  JobCounter() = default;
+  JobCounter(const JobCounter&) = delete;
+  JobCounter& operator=(const JobCounter&) = delete;
+
+  void Add(u32 count = 1)
+  {
+    mCount.fetch_add(count, std::memory_order_relaxed);
+  }
+
+  void Decrement()
+  {
+    mDecrementing.fetch_add(1, std::memory_order_seq_cst);
+    if (mCount.fetch_sub(1, std::memory_order_seq_cst) == 1)
+    {
+      mCount.notify_all();
+    }
+    // Last access, the counter may be gone right after.
+    mDecrementing.fetch_sub(1, std::memory_order_release);
+  }
+
+  // Runs job once the counter reached zero and RunContinuations was called,
+  // or right away if it already is zero. Only valid on counters that outlive
+  // their last Decrement, i.e. the shared ones behind a JobHandle.
+  void AddContinuation(Job&& job)
+  {
+    {
+      // Publish the flag before looking at the count, RunContinuations does the
+      // opposite, so at least one side sees the other.
+      std::lock_guard lock(mContinuationsMutex);
+      bHasContinuations.store(true, std::memory_order_seq_cst);
+      if (mCount.load(std::memory_order_seq_cst) != 0)
+      {
+        mContinuations.emplace_back(std::move(job));
+        return;
+      }
+    }
+    job();
+  }
+
+  void RunContinuations()
+  {
+    if (!bHasContinuations.load(std::memory_order_seq_cst))
+    {
+      return;
+    }
+
+    std::vector<Job> continuations;
+    {
+      std::lock_guard lock(mContinuationsMutex);
+      if (!IsZero())
+      {
+        return;
+      }
+      continuations.swap(mContinuations);
+    }
+    for (Job& continuation : continuations)
+    {
+      continuation();
+    }
+  }
+
+  u32 Get() const
+  {
+    return mCount.load(std::memory_order_acquire);
+  }
+
+  bool IsZero() const
+  {
+    return Get() == 0 && mDecrementing.load(std::memory_order_acquire) == 0;
+  }
+
+  void Wait() const
+  {
+    for (u32 count = Get(); count != 0; count = Get())
+    {
+      mCount.wait(count, std::memory_order_acquire);
+    }
+    // The last Decrement may still be inside notify_all.
+    while (mDecrementing.load(std::memory_order_acquire) != 0)
+    {
+      std::this_thread::yield();
+    }
+  }
+};
+
+class JobHandle
+{
+  std::shared_ptr<JobCounter> mCounter;
+
+public:
+  JobHandle() = default;
+  explicit JobHandle(std::shared_ptr<JobCounter> counter) : mCounter(std::move(counter))
+  {
+  }
+
+  bool IsValid() const
+  {
+    return mCounter != nullptr;
+  }
+
+  bool IsDone() const
+  {
+    return !mCounter || mCounter->IsZero();
+  }
+
+  const JobCounter* GetCounter() const
+  {
+    return mCounter.get();
+  }
+
+  void Wait() const
+  {
+    if (mCounter)
+    {
+      mCounter->Wait();
+    }
+  }
+
+  void AddContinuation(Job&& job) const
+  {
+    if (mCounter)
+    {
+      mCounter->AddContinuation(std::move(job));
+    }
+    else
+    {
+      job();
+    }
+  }
+};
+
+} // namespace tk
+
+#endif // !TK_JOB_H
@@ -0,0 +1,149 @@
+#ifndef TK_MPMC_QUEUE_H
+#define TK_MPMC_QUEUE_H
+
+#include "core/threads/cache_line.h"
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace tk
+{
+
+// Bounded multi producer, multi consumer queue after Dmitry Vyukov's design.
+// Every cell carries a sequence number telling producers and consumers whose
+// turn it is, so claiming a cell is a single CAS on the head or tail index.
+template <typename T> class MPMCQueue
+{
+  struct Cell
+  {
+    std::atomic<u64> Sequence;
+    alignas(T) std::byte Data[sizeof(T)];
+  };
+
+  u64 mMask;
+  std::unique_ptr<Cell[]> mCells;
+
+  alignas(CacheLineSize) std::atomic<u64> mEnqueuePos = 0;
+  alignas(CacheLineSize) std::atomic<u64> mDequeuePos = 0;
+
+public:
+  explicit MPMCQueue(u64 capacity)
+  {
+    u64 size = 2;
+    while (size < capacity)
+    {
+      size <<= 1;
+    }
+    mMask = size - 1;
+    mCells.reset(new Cell[size]);
+    for (u64 i = 0; i < size; i++)
+    {
+      mCells[i].Sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  MPMCQueue(const MPMCQueue&) = delete;
+  MPMCQueue& operator=(const MPMCQueue&) = delete;
+
+  ~MPMCQueue()
+  {
+    u64 enqueued = mEnqueuePos.load(std::memory_order_acquire);
+    for (u64 pos = mDequeuePos.load(std::memory_order_relaxed); pos != enqueued; pos++)
+    {
+      std::launder(reinterpret_cast<T*>(mCells[pos & mMask].Data))->~T();
+    }
+  }
+
+  template <typename... Args> bool TryEmplace(Args&&... args)
+  {
+    u64 pos = mEnqueuePos.load(std::memory_order_relaxed);
+    Cell* cell;
+    while (true)
+    {
+      cell = &mCells[pos & mMask];
+      u64 sequence = cell->Sequence.load(std::memory_order_acquire);
+      i64 diff = (i64)sequence - (i64)pos;
+      if (diff == 0)
+      {
+        if (mEnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+        {
+          break;
+        }
+      }
+      else if (diff < 0)
+      {
+        return false;
+      }
+      else
+      {
+        pos = mEnqueuePos.load(std::memory_order_relaxed);
+      }
+    }
+
+    new (cell->Data) T(std::forward<Args>(args)...);
+    cell->Sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool TryPush(const T& value)
+  {
+    return TryEmplace(value);
+  }
+
+  bool TryPush(T&& value)
+  {
+    return TryEmplace(std::move(value));
+  }
+
+  bool TryPop(T& outValue)
+  {
+    u64 pos = mDequeuePos.load(std::memory_order_relaxed);
+    Cell* cell;
+    while (true)
+    {
+      cell = &mCells[pos & mMask];
+      u64 sequence = cell->Sequence.load(std::memory_order_acquire);
+      i64 diff = (i64)sequence - (i64)(pos + 1);
+      if (diff == 0)
+      {
+        if (mDequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+        {
+          break;
+        }
+      }
+      else if (diff < 0)
+      {
+        return false;
+      }
+      else
+      {
+        pos = mDequeuePos.load(std::memory_order_relaxed);
+      }
+    }
+
+    T* value = std::launder(reinterpret_cast<T*>(cell->Data));
+    outValue = std::move(*value);
+    value->~T();
+    cell->Sequence.store(pos + mMask + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Approximate while producers or consumers are active.
+  u64 Size() const
+  {
+    u64 enqueued = mEnqueuePos.load(std::memory_order_relaxed);
+    u64 dequeued = mDequeuePos.load(std::memory_order_relaxed);
+    return enqueued > dequeued ? enqueued - dequeued : 0;
+  }
+
+  u64 Capacity() const
+  {
+    return mMask + 1;
+  }
+};
+
+} // namespace tk
+
+#endif // !TK_MPMC_QUEUE_H
@@ -0,0 +1,117 @@
+#ifndef TK_SPSC_QUEUE_H
+#define TK_SPSC_QUEUE_H
+
+#include "core/threads/cache_line.h"
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace tk
+{
+
+// Bounded single producer, single consumer ring buffer. Each side keeps a
+// cached copy of the other side's index and only reloads it when the queue
+// looks full (or empty), so the shared cache lines are touched rarely.
+template <typename T> class SPSCQueue
+{
+  struct alignas(T) Slot
+  {
+    std::byte Data[sizeof(T)];
+  };
+
+  u64 mMask;
+  std::unique_ptr<Slot[]> mSlots;
+
+  alignas(CacheLineSize) std::atomic<u64> mHead = 0;
+  alignas(CacheLineSize) u64 mCachedTail = 0;
+  alignas(CacheLineSize) std::atomic<u64> mTail = 0;
+  alignas(CacheLineSize) u64 mCachedHead = 0;
+
+public:
+  explicit SPSCQueue(u64 capacity)
+  {
+    u64 size = 1;
+    while (size < capacity)
+    {
+      size <<= 1;
+    }
+    mMask = size - 1;
+    mSlots.reset(new Slot[size]);
+  }
+
+  SPSCQueue(const SPSCQueue&) = delete;
+  SPSCQueue& operator=(const SPSCQueue&) = delete;
+
+  ~SPSCQueue()
+  {
+    u64 tail = mTail.load(std::memory_order_acquire);
+    for (u64 head = mHead.load(std::memory_order_relaxed); head != tail; head++)
+    {
+      std::launder(reinterpret_cast<T*>(mSlots[head & mMask].Data))->~T();
+    }
+  }
+
+  // Producer only.
+  template <typename... Args> bool TryEmplace(Args&&... args)
+  {
+    u64 tail = mTail.load(std::memory_order_relaxed);
+    if (tail - mCachedHead > mMask)
+    {
+      mCachedHead = mHead.load(std::memory_order_acquire);
+      if (tail - mCachedHead > mMask)
+      {
+        return false;
+      }
+    }
+
+    new (mSlots[tail & mMask].Data) T(std::forward<Args>(args)...);
+    mTail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool TryPush(const T& value)
+  {
+    return TryEmplace(value);
+  }
+
+  bool TryPush(T&& value)
+  {
+    return TryEmplace(std::move(value));
+  }
+
+  // Consumer only.
+  bool TryPop(T& outValue)
+  {
+    u64 head = mHead.load(std::memory_order_relaxed);
+    if (head == mCachedTail)
+    {
+      mCachedTail = mTail.load(std::memory_order_acquire);
+      if (head == mCachedTail)
+      {
+        return false;
+      }
+    }
+
+    T* value = std::launder(reinterpret_cast<T*>(mSlots[head & mMask].Data));
+    outValue = std::move(*value);
+    value->~T();
+    mHead.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  u64 Size() const
+  {
+    return mTail.load(std::memory_order_acquire) - mHead.load(std::memory_order_acquire);
+  }
+
+  u64 Capacity() const
+  {
+    return mMask + 1;
+  }
+};
+
+} // namespace tk
+
+#endif // !TK_SPSC_QUEUE_H
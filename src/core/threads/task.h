@@ -0,0 +1,366 @@
+#ifndef TK_TASK_H
+#define TK_TASK_H
+
+#include "core/logger.h"
+#include "core/threads/job.h"
+#include "core/threads/thread_pool.h"
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+
+namespace tk
+{
+
+template <typename T = void> class Task;
+
+namespace detail
+{
+
+struct TaskPromiseBase
+{
+  std::coroutine_handle<> mContinuation = std::noop_coroutine();
+  std::exception_ptr mException = nullptr;
+
+  struct FinalAwaiter
+  {
+    bool await_ready() noexcept
+    {
+      return false;
+    }
+    template <typename P> std::coroutine_handle<> await_suspend(std::coroutine_handle<P> handle) noexcept
+    {
+      return handle.promise().mContinuation;
+    }
+    void await_resume() noexcept
+    {
+    }
+  };
+
+  std::suspend_always initial_suspend() noexcept
+  {
+    return {};
+  }
+  FinalAwaiter final_suspend() noexcept
+  {
+    return {};
+  }
+  void unhandled_exception()
+  {
+    mException = std::current_exception();
+  }
+};
+
+template <typename T> struct TaskPromise : TaskPromiseBase
+{
+  std::optional<T> mValue = std::nullopt;
+
+  Task<T> get_return_object();
+  void return_value(T value)
+  {
+    mValue.emplace(std::move(value));
+  }
+  T Result()
+  {
+    if (mException)
+    {
+      std::rethrow_exception(mException);
+    }
+    return std::move(*mValue);
+  }
+};
+
+template <> struct TaskPromise<void> : TaskPromiseBase
+{
+  Task<void> get_return_object();
+  void return_void()
+  {
+  }
+  void Result()
+  {
+    if (mException)
+    {
+      std::rethrow_exception(mException);
+    }
+  }
+};
+
+// Starts running as soon as it is created and frees itself when done.
+struct DetachedTask
+{
+  struct promise_type
+  {
+    DetachedTask get_return_object()
+    {
+      return {};
+    }
+    std::suspend_never initial_suspend() noexcept
+    {
+      return {};
+    }
+    std::suspend_never final_suspend() noexcept
+    {
+      return {};
+    }
+    void return_void()
+    {
+    }
+    void unhandled_exception()
+    {
+      std::terminate();
+    }
+  };
+};
+
+} // namespace detail
+
+// Lazily started coroutine. Awaiting a Task starts it and resumes the awaiter
+// once it finishes, on whichever thread finished it.
+template <typename T> class [[nodiscard]] Task
+{
+public:
+  using promise_type = detail::TaskPromise<T>;
+
+private:
+  std::coroutine_handle<promise_type> mHandle = nullptr;
+
+public:
+  Task() = default;
+  explicit Task(std::coroutine_handle<promise_type> handle) : mHandle(handle)
+  {
+  }
+  Task(Task&& other) noexcept : mHandle(std::exchange(other.mHandle, nullptr))
+  {
+  }
+  Task& operator=(Task&& other) noexcept
+  {
+    if (this != &other)
+    {
+      Reset();
+      mHandle = std::exchange(other.mHandle, nullptr);
+    }
+    return *this;
+  }
+  Task(const Task&) = delete;
+  Task& operator=(const Task&) = delete;
+
+  ~Task()
+  {
+    Reset();
+  }
+
+  bool IsValid() const
+  {
+    return mHandle != nullptr;
+  }
+
+  bool IsDone() const
+  {
+    return !mHandle || mHandle.done();
+  }
+
+  auto operator co_await() && noexcept
+  {
+    struct Awaiter
+    {
+      std::coroutine_handle<promise_type> mHandle;
+
+      bool await_ready() noexcept
+      {
+        return !mHandle || mHandle.done();
+      }
+      std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiter) noexcept
+      {
+        mHandle.promise().mContinuation = awaiter;
+        return mHandle;
+      }
+      T await_resume()
+      {
+        return mHandle.promise().Result();
+      }
+    };
+    return Awaiter{mHandle};
+  }
+
+private:
+  void Reset()
+  {
+    if (mHandle)
+    {
+      mHandle.destroy();
+      mHandle = nullptr;
+    }
+  }
+};
+
+namespace detail
+{
+
+template <typename T> Task<T> TaskPromise<T>::get_return_object()
+{
+  return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+}
+
+inline Task<void> TaskPromise<void>::get_return_object()
+{
+  return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+}
+
+} // namespace detail
+
+// co_await ScheduleOn(pool) continues the coroutine on a pool worker.
+inline auto ScheduleOn(ThreadPool& pool)
+{
+  struct Awaiter
+  {
+    ThreadPool& mPool;
+
+    bool await_ready() noexcept
+    {
+      return false;
+    }
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+      mPool.Schedule([handle]() { handle.resume(); });
+    }
+    void await_resume() noexcept
+    {
+    }
+  };
+  return Awaiter{pool};
+}
+
+// co_await AwaitJob(pool, handle) suspends until the job finished, then
+// continues on a pool worker.
+inline auto AwaitJob(ThreadPool& pool, JobHandle job)
+{
+  struct Awaiter
+  {
+    ThreadPool& mPool;
+    JobHandle mJob;
+
+    bool await_ready() noexcept
+    {
+      return mJob.IsDone();
+    }
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+      mJob.AddContinuation([pool = &mPool, handle]() { pool->Schedule([handle]() { handle.resume(); }); });
+    }
+    void await_resume() noexcept
+    {
+    }
+  };
+  return Awaiter{pool, std::move(job)};
+}
+
+namespace detail
+{
+
+// Outcome of a task driven by DriveTask, read once its counter is zero.
+template <typename T> struct TaskResult
+{
+  std::optional<T> Value = std::nullopt;
+  std::exception_ptr Exception = nullptr;
+
+  T Get()
+  {
+    if (Exception)
+    {
+      std::rethrow_exception(Exception);
+    }
+    return std::move(*Value);
+  }
+};
+
+template <> struct TaskResult<void>
+{
+  std::exception_ptr Exception = nullptr;
+
+  void Get()
+  {
+    if (Exception)
+    {
+      std::rethrow_exception(Exception);
+    }
+  }
+};
+
+inline void LogException(std::exception_ptr exception)
+{
+  try
+  {
+    std::rethrow_exception(exception);
+  }
+  catch (const std::exception& e)
+  {
+    Logger::Error("Task failed: {}", e.what());
+  }
+  catch (...)
+  {
+    Logger::Error("Task failed with an unknown exception");
+  }
+}
+
+// Without a result to store it in, a failure is only logged.
+template <typename T>
+DetachedTask DriveTask(ThreadPool& pool, Task<T> task, std::shared_ptr<JobCounter> counter, TaskResult<T>* result)
+{
+  co_await ScheduleOn(pool);
+  try
+  {
+    if constexpr (std::is_void_v<T>)
+    {
+      co_await std::move(task);
+    }
+    else if (result)
+    {
+      result->Value.emplace(co_await std::move(task));
+    }
+    else
+    {
+      co_await std::move(task);
+    }
+  }
+  catch (...)
+  {
+    if (result)
+    {
+      result->Exception = std::current_exception();
+    }
+    else
+    {
+      LogException(std::current_exception());
+    }
+  }
+  counter->Decrement();
+  counter->RunContinuations();
+}
+
+} // namespace detail
+
+// Runs a task on the pool without an awaiting coroutine. The handle completes
+// once the task returned or threw, exceptions are logged.
+template <typename T> JobHandle Spawn(ThreadPool& pool, Task<T> task)
+{
+  std::shared_ptr<JobCounter> counter = std::make_shared<JobCounter>();
+  counter->Add();
+  detail::DriveTask<T>(pool, std::move(task), counter, nullptr);
+  return JobHandle(std::move(counter));
+}
+
+// Blocks the calling thread until the task finished on the pool, running other
+// jobs in the meantime. Rethrows whatever the task threw.
+template <typename T> T SyncWait(ThreadPool& pool, Task<T> task)
+{
+  std::shared_ptr<JobCounter> counter = std::make_shared<JobCounter>();
+  counter->Add();
+  detail::TaskResult<T> result = {};
+  detail::DriveTask<T>(pool, std::move(task), counter, &result);
+  pool.Wait(*counter);
+  return result.Get();
+}
+
+} // namespace tk
+
+#endif // !TK_TASK_H
@@ -6,31 +6,394 @@
 namespace tk
 {
 
-ThreadPool::ThreadPool() : mNumWorkers(std::thread::hardware_concurrency())
+ThreadPool::ThreadPool(u32 numWorkers) : ThreadPool(ThreadPoolConfig{numWorkers})
 {
+}
+
+ThreadPool::ThreadPool(const ThreadPoolConfig& config) : mConfig(config), mNumWorkers(config.NumWorkers)
+{
+  if (mNumWorkers == 0)
+  {
+    // Leave the cores of dedicated threads to them.
+    u32 numCores = std::thread::hardware_concurrency();
+    u32 numDedicated = (u32)mConfig.DedicatedThreads.size();
+    mNumWorkers = numCores > numDedicated ? numCores - numDedicated : 0;
+  }
   if (mNumWorkers == 0)
   {
     mNumWorkers = 1;
   }
 }
 
+ThreadPool::~ThreadPool()
+{
+  Shutdown();
+}
+
 void ThreadPool::Run()
 {
+  if (bRunning.exchange(true, std::memory_order_acq_rel))
+  {
+    return;
+  }
+
+  // All workers must exist before any of them starts stealing.
+  u32 numDedicated = (u32)mConfig.DedicatedThreads.size();
   for (u32 i = 0u; i < mNumWorkers; i++)
   {
-    WorkerThread* thread = new WorkerThread();
-    thread->SetFunction([i]() { Logger::Info("Id: {}", i); });
+    WorkerThreadDesc desc{};
+    desc.Core = mConfig.bPinWorkers ? (i32)(numDedicated + i) : -1;
+    WorkerThread* thread = new WorkerThread(this, desc);
     thread->SetId(i);
-    thread->Run();
     mWorkers.emplace_back(thread);
   }
 
+  for (u32 i = 0u; i < numDedicated; i++)
+  {
+    WorkerThread* thread = new WorkerThread(this, mConfig.DedicatedThreads[i]);
+    thread->SetId(mNumWorkers + i);
+    mDedicatedThreads.emplace_back(thread);
+  }
+
+  for (WorkerThread* worker : mWorkers)
+  {
+    worker->Run();
+  }
+  for (WorkerThread* thread : mDedicatedThreads)
+  {
+    thread->Run();
+  }
+
+  Logger::Info("Started {} worker threads and {} dedicated threads", mNumWorkers, numDedicated);
+}
+
+void ThreadPool::Shutdown()
+{
+  {
+    std::lock_guard lock(mSleepMutex);
+    if (!bRunning.exchange(false, std::memory_order_acq_rel))
+    {
+      return;
+    }
+  }
+  mSleepCondition.notify_all();
+  for (WorkerThread* thread : mDedicatedThreads)
+  {
+    thread->Wake();
+  }
+
+  for (WorkerThread* thread : mDedicatedThreads)
+  {
+    thread->Join();
+  }
   for (WorkerThread* worker : mWorkers)
   {
     worker->Join();
   }
+  for (WorkerThread* thread : mDedicatedThreads)
+  {
+    delete thread;
+  }
+  for (WorkerThread* worker : mWorkers)
+  {
+    delete worker;
+  }
+  mDedicatedThreads.clear();
+  mWorkers.clear();
 
   Logger::Info("All threads have completed their work");
 }
 
+JobHandle ThreadPool::Submit(Job&& job)
+{
+  std::shared_ptr<JobCounter> counter = std::make_shared<JobCounter>();
+  counter->Add();
+  Enqueue([job = std::move(job), counter]() {
+    job();
+    counter->Decrement();
+    counter->RunContinuations();
+  });
+  return JobHandle(std::move(counter));
+}
+
+void ThreadPool::Submit(Job&& job, JobCounter& counter)
+{
+  counter.Add();
+  Enqueue([job = std::move(job), &counter]() {
+    job();
+    counter.Decrement();
+  });
+}
+
+void ThreadPool::Schedule(Job&& job)
+{
+  Enqueue(std::move(job));
+}
+
+JobHandle ThreadPool::Submit(Job&& job, EWorkerThreadType type)
+{
+  std::shared_ptr<JobCounter> counter = std::make_shared<JobCounter>();
+  counter->Add();
+  Enqueue(
+      [job = std::move(job), counter]() {
+        job();
+        counter->Decrement();
+        counter->RunContinuations();
+      },
+      type);
+  return JobHandle(std::move(counter));
+}
+
+void ThreadPool::Submit(Job&& job, EWorkerThreadType type, JobCounter& counter)
+{
+  counter.Add();
+  Enqueue(
+      [job = std::move(job), &counter]() {
+        job();
+        counter.Decrement();
+      },
+      type);
+}
+
+void ThreadPool::Wait(const JobCounter& counter)
+{
+  if (!CanHelp())
+  {
+    counter.Wait();
+    return;
+  }
+
+  // Empty queues don't mean the rest is running elsewhere, the running jobs
+  // may still queue more, so keep checking for work instead of blocking on
+  // the counter.
+  WaitUntil([&counter]() { return counter.IsZero(); });
+}
+
+void ThreadPool::Wait(const JobHandle& handle)
+{
+  if (const JobCounter* counter = handle.GetCounter())
+  {
+    Wait(*counter);
+  }
+}
+
+bool ThreadPool::CanHelp() const
+{
+  WorkerThread* worker = WorkerThread::Current();
+  return !worker || worker->GetPool() != this || !worker->IsDedicated();
+}
+
+u32 ThreadPool::GetNumWorkers() const
+{
+  return mNumWorkers;
+}
+
+u32 ThreadPool::GetNumThreads() const
+{
+  return mNumWorkers + (u32)mConfig.DedicatedThreads.size();
+}
+
+bool ThreadPool::HasDedicatedThread(EWorkerThreadType type) const
+{
+  for (const WorkerThread* thread : mDedicatedThreads)
+  {
+    if (thread->GetType() == type)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+void ThreadPool::GetStats(ThreadPoolStats& outStats) const
+{
+  outStats.Workers.clear();
+  for (const WorkerThread* worker : mWorkers)
+  {
+    outStats.Workers.push_back(worker->GetStatsSnapshot());
+  }
+  for (const WorkerThread* thread : mDedicatedThreads)
+  {
+    outStats.Workers.push_back(thread->GetStatsSnapshot());
+  }
+  outStats.TimestampNs = WorkerThread::NowNs();
+  outStats.QueuedJobs = mQueuedJobs.load(std::memory_order_relaxed);
+  outStats.InjectedJobs = mInjectedDepth.load(std::memory_order_relaxed);
+}
+
+bool ThreadPool::Running() const
+{
+  return bRunning.load(std::memory_order_acquire);
+}
+
+void ThreadPool::Enqueue(Job&& job)
+{
+  Job* heapJob = new Job(std::move(job));
+
+  WorkerThread* worker = WorkerThread::Current();
+  if (worker && worker->GetPool() == this && !worker->IsDedicated())
+  {
+    worker->GetJobs().Push(heapJob);
+  }
+  else
+  {
+    std::lock_guard lock(mInjectedMutex);
+    mInjectedJobs.push_back(heapJob);
+    mInjectedDepth.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  mQueuedJobs.fetch_add(1, std::memory_order_seq_cst);
+  if (mSleepingWorkers.load(std::memory_order_seq_cst) > 0)
+  {
+    std::lock_guard lock(mSleepMutex);
+    mSleepCondition.notify_one();
+  }
+}
+
+void ThreadPool::Enqueue(Job&& job, EWorkerThreadType type)
+{
+  // Round robin between dedicated threads of the same type. Types without a
+  // dedicated thread fall back to the General workers.
+  u32 numDedicated = (u32)mDedicatedThreads.size();
+  u32 start = numDedicated ? mNextDedicated.fetch_add(1, std::memory_order_relaxed) : 0;
+  for (u32 i = 0; i < numDedicated; i++)
+  {
+    WorkerThread* thread = mDedicatedThreads[(start + i) % numDedicated];
+    if (thread->GetType() == type)
+    {
+      thread->Post(new Job(std::move(job)));
+      return;
+    }
+  }
+
+  Enqueue(std::move(job));
+}
+
+Job* ThreadPool::FindJob(WorkerThread* worker)
+{
+  Job* job = nullptr;
+  if (worker && worker->GetJobs().Pop(job))
+  {
+    return job;
+  }
+  if ((job = PopInjected()))
+  {
+    return job;
+  }
+  return Steal(worker);
+}
+
+Job* ThreadPool::PopInjected()
+{
+  std::lock_guard lock(mInjectedMutex);
+  if (mInjectedJobs.empty())
+  {
+    return nullptr;
+  }
+  Job* job = mInjectedJobs.front();
+  mInjectedJobs.pop_front();
+  mInjectedDepth.fetch_sub(1, std::memory_order_relaxed);
+  return job;
+}
+
+Job* ThreadPool::Steal(WorkerThread* thief)
+{
+  if (mWorkers.empty())
+  {
+    return nullptr;
+  }
+
+  u32 start = thief ? thief->NextRandom() : 0;
+  for (u32 i = 0; i < mNumWorkers; i++)
+  {
+    WorkerThread* victim = mWorkers[(start + i) % mNumWorkers];
+    Job* job = nullptr;
+    if (victim != thief && victim->GetJobs().Steal(job))
+    {
+      if (thief)
+      {
+        WorkerStats::Add(thief->GetStats().Steals, 1);
+      }
+      return job;
+    }
+  }
+  return nullptr;
+}
+
+bool ThreadPool::Park()
+{
+  std::unique_lock lock(mSleepMutex);
+  mSleepingWorkers.fetch_add(1, std::memory_order_seq_cst);
+  mSleepCondition.wait(lock, [this]() {
+    return mQueuedJobs.load(std::memory_order_seq_cst) > 0 || !bRunning.load(std::memory_order_acquire);
+  });
+  mSleepingWorkers.fetch_sub(1, std::memory_order_relaxed);
+
+  // Drain whatever is left on shutdown so no JobHandle is left waiting forever.
+  return bRunning.load(std::memory_order_acquire) || mQueuedJobs.load(std::memory_order_acquire) > 0;
+}
+
+void ThreadPool::Execute(Job* job)
+{
+  mQueuedJobs.fetch_sub(1, std::memory_order_relaxed);
+  (*job)();
+  delete job;
+}
+
+bool ThreadPool::RunPendingJob()
+{
+  if (!CanHelp())
+  {
+    return false;
+  }
+
+  // Only our own General workers may pop from their deque, everyone else
+  // takes from the injection queue or steals.
+  WorkerThread* worker = WorkerThread::Current();
+  Job* job = FindJob(worker && worker->GetPool() == this ? worker : nullptr);
+  if (!job)
+  {
+    return false;
+  }
+
+  Execute(job);
+  return true;
+}
+
+void ThreadPool::WorkerMain(WorkerThread& worker)
+{
+  WorkerStats& stats = worker.GetStats();
+  u64 idleStart = WorkerThread::NowNs();
+
+  while (true)
+  {
+    if (Job* job = FindJob(&worker))
+    {
+      u64 busyStart = WorkerThread::NowNs();
+      WorkerStats::Add(stats.IdleNs, busyStart - idleStart);
+      stats.JobStartNs.store(busyStart, std::memory_order_relaxed);
+
+      Execute(job);
+
+      idleStart = WorkerThread::NowNs();
+      WorkerStats::Add(stats.BusyNs, idleStart - busyStart);
+      WorkerStats::Add(stats.JobsExecuted, 1);
+      stats.JobStartNs.store(0, std::memory_order_relaxed);
+      continue;
+    }
+
+    if (mQueuedJobs.load(std::memory_order_acquire) > 0)
+    {
+      // Another thread's deque is mid push/pop, try again before parking.
+      std::this_thread::yield();
+      continue;
+    }
+
+    if (!Park())
+    {
+      return;
+    }
+  }
+}
+
 } // namespace tk
@@ -2,21 +2,190 @@
 #define TK_JOBS_H
 
 #include "core/dynamic_array.h"
+#include "core/threads/cache_line.h"
+#include "core/threads/job.h"
 #include "core/threads/worker_thread.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
 
 namespace tk
 {
 
+struct ThreadPoolConfig
+{
+  u32 NumWorkers = 0;
+  bool bPinWorkers = false;
+  DynamicArray<WorkerThreadDesc> DedicatedThreads = {};
+};
+
+struct ThreadPoolStats
+{
+  DynamicArray<WorkerStatsSnapshot> Workers = {};
+  u64 TimestampNs = 0;
+  u64 QueuedJobs = 0;
+  u64 InjectedJobs = 0;
+};
+
+// Work-stealing job system. Jobs submitted from a worker go to that worker's
+// own deque, jobs submitted from any other thread go to a shared injection
+// queue. Idle workers steal from random victims before parking. Jobs routed
+// to a dedicated thread type never run on General workers and vice versa.
 class ThreadPool
 {
+  ThreadPoolConfig mConfig = {};
   DynamicArray<class WorkerThread*> mWorkers = {};
+  DynamicArray<class WorkerThread*> mDedicatedThreads = {};
+  std::atomic<u32> mNextDedicated = 0;
   u32 mNumWorkers = 0;
 
+  std::deque<Job*> mInjectedJobs = {};
+  std::mutex mInjectedMutex;
+  std::atomic<u64> mInjectedDepth = 0;
+
+  alignas(CacheLineSize) std::atomic<u32> mQueuedJobs = 0;
+  alignas(CacheLineSize) std::atomic<u32> mSleepingWorkers = 0;
+  std::mutex mSleepMutex;
+  std::condition_variable mSleepCondition;
+  std::atomic<bool> bRunning = false;
+
+  static constexpr u32 HelpSpinCount = 64;
+  static constexpr std::chrono::microseconds HelpSleep{50};
+
+  friend class WorkerThread;
+
 public:
-  ThreadPool();
+  ThreadPool(u32 numWorkers = 0);
+  ThreadPool(const ThreadPoolConfig& config);
+  ~ThreadPool();
+
   void Run();
+  void Shutdown();
+
+  JobHandle Submit(Job&& job);
+  void Submit(Job&& job, JobCounter& counter);
+  void Schedule(Job&& job);
+  JobHandle Submit(Job&& job, EWorkerThreadType type);
+  void Submit(Job&& job, EWorkerThreadType type, JobCounter& counter);
+
+  template <typename Func> void ParallelFor(u32 count, u32 grainSize, Func&& func);
+
+  // Helping waits: the calling thread runs queued jobs until the wait is over
+  // instead of sleeping. Dedicated threads never pick up General jobs, they
+  // only wait.
+  void Wait(const JobCounter& counter);
+  void Wait(const JobHandle& handle);
+  template <typename Pred> void WaitUntil(Pred&& pred);
+
+  // Whether a helping wait on the calling thread actually runs jobs.
+  bool CanHelp() const;
+
+  u32 GetNumWorkers() const;
+  // Workers plus dedicated threads, every pool thread's id is below this.
+  u32 GetNumThreads() const;
+  bool HasDedicatedThread(EWorkerThreadType type) const;
+
+  // Lock-free: every counter is read with a relaxed load, so values of
+  // different workers may be a few jobs apart.
+  void GetStats(ThreadPoolStats& outStats) const;
+  bool Running() const;
+
+private:
+  void Enqueue(Job&& job);
+  void Enqueue(Job&& job, EWorkerThreadType type);
+  Job* FindJob(WorkerThread* worker);
+  Job* PopInjected();
+  Job* Steal(WorkerThread* thief);
+  bool Park();
+  void Execute(Job* job);
+  bool RunPendingJob();
+  void WorkerMain(WorkerThread& worker);
 };
 
+// Splits [0, count) into chunks of grainSize and calls func(begin, end) for
+// each. The calling thread claims chunks as well and only waits for chunks
+// that are already running, so this is safe to call from inside a job.
+template <typename Func> void ThreadPool::ParallelFor(u32 count, u32 grainSize, Func&& func)
+{
+  if (count == 0)
+  {
+    return;
+  }
+
+  grainSize = grainSize == 0 ? 1 : grainSize;
+  u32 numChunks = (count + grainSize - 1) / grainSize;
+  if (numChunks == 1 || !Running())
+  {
+    func(0u, count);
+    return;
+  }
+
+  struct Chunks
+  {
+    std::atomic<u32> Next = 0;
+    std::atomic<u32> Done = 0;
+  };
+  std::shared_ptr<Chunks> chunks = std::make_shared<Chunks>();
+
+  // Helpers that start after every chunk was claimed return without touching
+  // func, which may be out of scope by then.
+  auto work = [chunks, numChunks, count, grainSize, &func]() {
+    for (u32 chunk = chunks->Next.fetch_add(1, std::memory_order_relaxed); chunk < numChunks;
+         chunk = chunks->Next.fetch_add(1, std::memory_order_relaxed))
+    {
+      u32 begin = chunk * grainSize;
+      u32 end = begin + grainSize < count ? begin + grainSize : count;
+      func(begin, end);
+      if (chunks->Done.fetch_add(1, std::memory_order_acq_rel) + 1 == numChunks)
+      {
+        chunks->Done.notify_all();
+      }
+    }
+  };
+
+  u32 numHelpers = numChunks - 1 < mNumWorkers ? numChunks - 1 : mNumWorkers;
+  for (u32 i = 0; i < numHelpers; i++)
+  {
+    Enqueue(work);
+  }
+  work();
+
+  for (u32 done = chunks->Done.load(std::memory_order_acquire); done != numChunks;
+       done = chunks->Done.load(std::memory_order_acquire))
+  {
+    chunks->Done.wait(done, std::memory_order_acquire);
+  }
+}
+
+// For conditions nothing can be notified on, e.g. a Vulkan fence, and for
+// counters whose jobs may still be queued. Backs off to short sleeps once there
+// is nothing left to help with.
+template <typename Pred> void ThreadPool::WaitUntil(Pred&& pred)
+{
+  u32 spins = 0;
+  while (!pred())
+  {
+    if (RunPendingJob())
+    {
+      spins = 0;
+      continue;
+    }
+
+    if (spins++ < HelpSpinCount)
+    {
+      std::this_thread::yield();
+    }
+    else
+    {
+      std::this_thread::sleep_for(HelpSleep);
+    }
+  }
+}
+
 } // namespace tk
 
 #endif // !TK_JOBS_H
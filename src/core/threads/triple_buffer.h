@@ -0,0 +1,105 @@
+#ifndef TK_TRIPLE_BUFFER_H
+#define TK_TRIPLE_BUFFER_H
+
+#include "core/threads/cache_line.h"
+#include <atomic>
+
+namespace tk
+{
+
+// Single producer, single consumer triple buffer. The producer always has a
+// slot to write into and the consumer always reads the most recently
+// published one, neither ever touches the other's slot.
+template <typename T> class TripleBuffer
+{
+  static constexpr u8 IndexMask = 0b011;
+  static constexpr u8 FreshBit = 0b100;
+  static constexpr u8 StopBit = 0b1000;
+
+  T mSlots[3] = {};
+  alignas(CacheLineSize) std::atomic<u8> mMiddle = 2;
+  alignas(CacheLineSize) u8 mBack = 0;
+  alignas(CacheLineSize) u8 mFront = 1;
+
+public:
+  // Producer side.
+  T& GetWriteSlot()
+  {
+    return mSlots[mBack];
+  }
+
+  void Publish()
+  {
+    u8 middle = mMiddle.load(std::memory_order_relaxed);
+    while (!mMiddle.compare_exchange_weak(middle, mBack | FreshBit | (middle & StopBit), std::memory_order_acq_rel))
+    {
+    }
+    mBack = middle & IndexMask;
+    mMiddle.notify_all();
+  }
+
+  // Blocks until the consumer picked up the last published slot. Returns false
+  // once stopped.
+  bool WaitForConsumer() const
+  {
+    for (u8 middle = mMiddle.load(std::memory_order_acquire); !(middle & StopBit);
+         middle = mMiddle.load(std::memory_order_acquire))
+    {
+      if (!(middle & FreshBit))
+      {
+        return true;
+      }
+      mMiddle.wait(middle, std::memory_order_acquire);
+    }
+    return false;
+  }
+
+  // Non-blocking WaitForConsumer, true once the last published slot was picked
+  // up or the buffer was stopped.
+  bool Consumed() const
+  {
+    u8 middle = mMiddle.load(std::memory_order_acquire);
+    return !(middle & FreshBit) || (middle & StopBit);
+  }
+
+  // Consumer side. Returns the newest published slot, or nullptr once stopped.
+  const T* AcquireLatest(bool bWait = true)
+  {
+    for (u8 middle = mMiddle.load(std::memory_order_acquire); !(middle & StopBit);
+         middle = mMiddle.load(std::memory_order_acquire))
+    {
+      if (middle & FreshBit)
+      {
+        if (mMiddle.compare_exchange_strong(middle, mFront | (middle & StopBit), std::memory_order_acq_rel))
+        {
+          mFront = middle & IndexMask;
+          mMiddle.notify_all();
+          return &mSlots[mFront];
+        }
+        continue;
+      }
+
+      if (!bWait)
+      {
+        return &mSlots[mFront];
+      }
+      mMiddle.wait(middle, std::memory_order_acquire);
+    }
+    return nullptr;
+  }
+
+  void Stop()
+  {
+    mMiddle.fetch_or(StopBit, std::memory_order_acq_rel);
+    mMiddle.notify_all();
+  }
+
+  bool Stopped() const
+  {
+    return mMiddle.load(std::memory_order_acquire) & StopBit;
+  }
+};
+
+} // namespace tk
+
+#endif // !TK_TRIPLE_BUFFER_H
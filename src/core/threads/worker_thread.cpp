@@ -1,10 +1,24 @@
 #include "worker_thread.h"
+#include "core/logger.h"
+#include "core/threads/thread_pool.h"
+#include <chrono>
 #include <thread>
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
 namespace tk
 {
 
-WorkerThread::WorkerThread() : bPaused(false)
+thread_local WorkerThread* WorkerThread::sCurrent = nullptr;
+
+WorkerThread::WorkerThread(ThreadPool* pool, const WorkerThreadDesc& desc) : mPool(pool), mDesc(desc)
 {
   mThread = new std::thread;
 }
@@ -16,52 +30,214 @@ WorkerThread::~WorkerThread()
 
 void WorkerThread::Run()
 {
-  bRunning = true;
+  bRunning.store(true, std::memory_order_release);
   *mThread = std::thread([this]() {
-    while (Running())
+    sCurrent = this;
+    ApplyAffinity();
+    ApplyPriority();
+
+    if (IsDedicated())
     {
-      if (NotPaused())
-      {
-        mFunction();
-      }
+      DedicatedMain();
+    }
+    else
+    {
+      mPool->WorkerMain(*this);
     }
-  });
-}
 
-void WorkerThread::SetFunction(std::function<void()>&& func)
-{
-  mFunction = std::move(func);
+    sCurrent = nullptr;
+    bRunning.store(false, std::memory_order_release);
+  });
 }
 
 void WorkerThread::SetId(i16 id)
 {
   Id = id;
+  mRandomState = 0x9E3779B9u * (u32)(id + 1);
 }
 
-const std::function<void()>& WorkerThread::GetFunction() const
+i16 WorkerThread::GetId() const
 {
-  return mFunction;
+  return Id;
 }
 
-void WorkerThread::Pause()
+EWorkerThreadType WorkerThread::GetType() const
 {
-  bPaused = true;
+  return mDesc.Type;
 }
 
-bool WorkerThread::Running()
+bool WorkerThread::IsDedicated() const
 {
-  return bRunning;
+  return mDesc.Type != EWorkerThreadType::General && mDesc.Type != EWorkerThreadType::Undefined;
 }
 
-bool WorkerThread::NotPaused()
+bool WorkerThread::Running() const
 {
-  return !bPaused;
+  return bRunning.load(std::memory_order_acquire);
 }
 
 void WorkerThread::Join()
 {
-  bRunning = false;
-  mThread->join();
+  if (mThread->joinable())
+  {
+    mThread->join();
+  }
+}
+
+WorkStealingDeque<Job*>& WorkerThread::GetJobs()
+{
+  return mJobs;
+}
+
+ThreadPool* WorkerThread::GetPool() const
+{
+  return mPool;
+}
+
+u32 WorkerThread::NextRandom()
+{
+  // xorshift32, only used to pick steal victims.
+  mRandomState ^= mRandomState << 13;
+  mRandomState ^= mRandomState >> 17;
+  mRandomState ^= mRandomState << 5;
+  return mRandomState;
+}
+
+WorkerStats& WorkerThread::GetStats()
+{
+  return mStats;
+}
+
+WorkerStatsSnapshot WorkerThread::GetStatsSnapshot() const
+{
+  WorkerStatsSnapshot snapshot{};
+  snapshot.Id = Id;
+  snapshot.Type = mDesc.Type;
+  snapshot.BusyNs = mStats.BusyNs.load(std::memory_order_relaxed);
+  if (u64 jobStart = mStats.JobStartNs.load(std::memory_order_relaxed))
+  {
+    u64 now = NowNs();
+    snapshot.BusyNs += now > jobStart ? now - jobStart : 0;
+  }
+  snapshot.IdleNs = mStats.IdleNs.load(std::memory_order_relaxed);
+  snapshot.JobsExecuted = mStats.JobsExecuted.load(std::memory_order_relaxed);
+  snapshot.Steals = mStats.Steals.load(std::memory_order_relaxed);
+  snapshot.QueueDepth =
+      IsDedicated() ? mMailboxDepth.load(std::memory_order_relaxed) : (u64)mJobs.Size();
+  return snapshot;
+}
+
+u64 WorkerThread::NowNs()
+{
+  return (u64)std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void WorkerThread::Post(Job* job)
+{
+  {
+    std::lock_guard lock(mMailboxMutex);
+    mMailbox.push_back(job);
+    mMailboxDepth.fetch_add(1, std::memory_order_relaxed);
+  }
+  mMailboxCondition.notify_one();
+}
+
+void WorkerThread::Wake()
+{
+  {
+    std::lock_guard lock(mMailboxMutex);
+  }
+  mMailboxCondition.notify_all();
+}
+
+WorkerThread* WorkerThread::Current()
+{
+  return sCurrent;
+}
+
+void WorkerThread::DedicatedMain()
+{
+  u64 idleStart = NowNs();
+  while (true)
+  {
+    Job* job = nullptr;
+    {
+      std::unique_lock lock(mMailboxMutex);
+      mMailboxCondition.wait(lock, [this]() { return !mMailbox.empty() || !mPool->Running(); });
+      if (mMailbox.empty())
+      {
+        return;
+      }
+      job = mMailbox.front();
+      mMailbox.pop_front();
+      mMailboxDepth.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    u64 busyStart = NowNs();
+    WorkerStats::Add(mStats.IdleNs, busyStart - idleStart);
+    mStats.JobStartNs.store(busyStart, std::memory_order_relaxed);
+
+    (*job)();
+    delete job;
+
+    idleStart = NowNs();
+    WorkerStats::Add(mStats.BusyNs, idleStart - busyStart);
+    WorkerStats::Add(mStats.JobsExecuted, 1);
+    mStats.JobStartNs.store(0, std::memory_order_relaxed);
+  }
+}
+
+void WorkerThread::ApplyAffinity()
+{
+  if (mDesc.Core < 0)
+  {
+    return;
+  }
+
+  u32 numCores = std::thread::hardware_concurrency();
+  u32 core = numCores ? (u32)mDesc.Core % numCores : (u32)mDesc.Core;
+
+#ifdef _WIN32
+  if (!SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << core))
+  {
+    Logger::Warning("Failed to pin worker {} to core {}", Id, core);
+  }
+#else
+  cpu_set_t cpuSet;
+  CPU_ZERO(&cpuSet);
+  CPU_SET(core, &cpuSet);
+  if (pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) != 0)
+  {
+    Logger::Warning("Failed to pin worker {} to core {}", Id, core);
+  }
+#endif
+}
+
+void WorkerThread::ApplyPriority()
+{
+  if (mDesc.Priority == EThreadPriority::Normal)
+  {
+    return;
+  }
+
+#ifdef _WIN32
+  static constexpr int Priorities[] = {THREAD_PRIORITY_BELOW_NORMAL, THREAD_PRIORITY_NORMAL,
+                                       THREAD_PRIORITY_ABOVE_NORMAL, THREAD_PRIORITY_TIME_CRITICAL};
+  if (!SetThreadPriority(GetCurrentThread(), Priorities[(u8)mDesc.Priority]))
+  {
+    Logger::Warning("Failed to set priority of worker {}", Id);
+  }
+#else
+  // Linux applies nice values per thread. Raising priority needs CAP_SYS_NICE,
+  // without it the thread keeps running at normal priority.
+  static constexpr int NiceValues[] = {10, 0, -5, -10};
+  if (setpriority(PRIO_PROCESS, (id_t)gettid(), NiceValues[(u8)mDesc.Priority]) != 0)
+  {
+    Logger::Warning("Failed to set priority of worker {}", Id);
+  }
+#endif
 }
 
 } // namespace tk
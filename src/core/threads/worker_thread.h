@@ -2,7 +2,12 @@
 #define TK_WORKER_THREAD_H
 
 #include "core/dynamic_array.h"
-#include <functional>
+#include "core/threads/job.h"
+#include "core/threads/work_stealing_deque.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
 
 enum class EWorkerThreadType : u8
 {
@@ -10,9 +15,18 @@ enum class EWorkerThreadType : u8
   Render,
   GameWrite,
   GameRead,
+  Network,
   General,
 };
 
+enum class EThreadPriority : u8
+{
+  Low = 0,
+  Normal,
+  High,
+  Critical,
+};
+
 namespace std
 {
 
@@ -23,28 +37,92 @@ class thread;
 namespace tk
 {
 
+struct WorkerThreadDesc
+{
+  EWorkerThreadType Type = EWorkerThreadType::General;
+  i32 Core = -1;
+  EThreadPriority Priority = EThreadPriority::Normal;
+};
+
+// Live counters, only ever written by the owning thread.
+struct WorkerStats
+{
+  std::atomic<u64> BusyNs = 0;
+  std::atomic<u64> IdleNs = 0;
+  std::atomic<u64> JobsExecuted = 0;
+  std::atomic<u64> Steals = 0;
+  // Non zero while a job runs, so long running jobs show up as busy before
+  // they finish.
+  std::atomic<u64> JobStartNs = 0;
+
+  static void Add(std::atomic<u64>& counter, u64 value)
+  {
+    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+  }
+};
+
+struct WorkerStatsSnapshot
+{
+  i16 Id = -1;
+  EWorkerThreadType Type = EWorkerThreadType::Undefined;
+  u64 BusyNs = 0;
+  u64 IdleNs = 0;
+  u64 JobsExecuted = 0;
+  u64 Steals = 0;
+  u64 QueueDepth = 0;
+};
+
 class WorkerThread
 {
-  u8 bRunning : 1;
-  u8 bPaused : 1;
+  std::atomic<bool> bRunning = false;
 
-  std::function<void()> mFunction;
-  EWorkerThreadType mThreadType = EWorkerThreadType::Undefined;
+  class ThreadPool* mPool;
+  WorkStealingDeque<Job*> mJobs;
+  WorkerThreadDesc mDesc = {};
   class std::thread* mThread;
+  u32 mRandomState = 0;
   i16 Id = -1;
 
+  // Dedicated (non General) threads are fed through a mailbox instead of
+  // taking part in work stealing.
+  std::deque<Job*> mMailbox = {};
+  std::mutex mMailboxMutex;
+  std::condition_variable mMailboxCondition;
+  std::atomic<u64> mMailboxDepth = 0;
+
+  alignas(CacheLineSize) WorkerStats mStats = {};
+
+  static thread_local WorkerThread* sCurrent;
+
 public:
-  WorkerThread();
+  WorkerThread(class ThreadPool* pool, const WorkerThreadDesc& desc = {});
   ~WorkerThread();
 
   void Run();
-  void SetFunction(std::function<void()>&& function);
-  const std::function<void()>& GetFunction() const;
   void SetId(i16 Id);
-  void Pause();
-  bool Running();
-  bool NotPaused();
+  i16 GetId() const;
+  EWorkerThreadType GetType() const;
+  bool IsDedicated() const;
+  bool Running() const;
   void Join();
+
+  WorkStealingDeque<Job*>& GetJobs();
+  class ThreadPool* GetPool() const;
+  u32 NextRandom();
+
+  WorkerStats& GetStats();
+  WorkerStatsSnapshot GetStatsSnapshot() const;
+  static u64 NowNs();
+
+  void Post(Job* job);
+  void Wake();
+
+  static WorkerThread* Current();
+
+private:
+  void ApplyAffinity();
+  void ApplyPriority();
+  void DedicatedMain();
 };
 
 } // namespace tk
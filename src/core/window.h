@@ -3,6 +3,7 @@
 
 #include <GLFW/glfw3.h>
 
+#include <atomic>
 #include <string>
 
 #include "core.h"
@@ -12,13 +13,14 @@ namespace tk
 
 class Window
 {
-  i32 mWidth;
-  i32 mHeight;
+  std::atomic<i32> mWidth;
+  std::atomic<i32> mHeight;
   std::string mName;
 
   GLFWwindow* pGlfwWindow{};
 
-  u8 mFramebufferResized : 1;
+  // Written by GLFW callbacks on the main thread, read by the render thread.
+  std::atomic<bool> mFramebufferResized;
 
 public:
   Window(i32 Width = 800, i32 Height = 600, std::string&& Name = "tk");
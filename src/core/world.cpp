@@ -0,0 +1,85 @@
+#include "world.h"
+#include "core/ecs/command_buffer.h"
+#include "core/engine.h"
+#include "core/systems/core_systems.h"
+#include <algorithm>
+#include <chrono>
+
+namespace tk
+{
+
+thread_local World* World::mCurrent = nullptr;
+
+World::World(u32 id, const WorldConfig& config)
+    : mId(id), mMemory(config.Memory), mRegistry(PoolAllocator<entt::entity>(&mMemory)), mClock(config.Simulation),
+      mTickBudget(config.TickBudget)
+{
+  Scope scope(this);
+  CoreSystems::ConnectTrackers(mRegistry);
+  CommandQueue::Connect(mRegistry, Engine::Get().GetThreadPool().GetNumThreads());
+  mSystems = new CoreSystems();
+  mSystems->Init(Engine::Get().GetThreadPool(), CommandQueue::Get(mRegistry));
+}
+
+World::~World()
+{
+  Scope scope(this);
+  mSystems->Shutdown();
+  delete mSystems;
+  mSystems = nullptr;
+  CommandQueue::Disconnect(mRegistry);
+  CoreSystems::DisconnectTrackers(mRegistry);
+}
+
+void World::Tick(f32 deltaTime)
+{
+  Scope scope(this);
+  auto start = std::chrono::steady_clock::now();
+  auto elapsed = [&start]() {
+    return std::chrono::duration<f64>(std::chrono::steady_clock::now() - start).count();
+  };
+
+  CommandQueue& commands = CommandQueue::Get(mRegistry);
+  mSystems->ResetTimings();
+  mSystems->Run<ESystemPhase::PreUpdate>(deltaTime);
+  commands.Playback(mRegistry);
+
+  f32 stepTime = mClock.GetStepTime();
+  u32 steps = mClock.Advance(deltaTime);
+  u32 step = 0;
+  for (; step < steps; step++)
+  {
+    if (step > 0 && mTickBudget > 0.0 && elapsed() > mTickBudget)
+    {
+      break;
+    }
+    mSystems->Run<ESystemPhase::FixedUpdate>(stepTime);
+    commands.Playback(mRegistry);
+  }
+  if (step < steps)
+  {
+    mClock.Defer(steps - step);
+    mStats.DeferredSteps += steps - step;
+  }
+
+  mSystems->Run<ESystemPhase::Update>(deltaTime);
+  commands.Playback(mRegistry);
+  mSystems->Run<ESystemPhase::PostUpdate>(deltaTime);
+  commands.Playback(mRegistry);
+
+  f64 tickTime = elapsed();
+  mStats.Ticks++;
+  mStats.LastTickTime = tickTime;
+  mStats.MaxTickTime = std::max(mStats.MaxTickTime, tickTime);
+  mStats.OverBudgetTicks += mTickBudget > 0.0 && tickTime > mTickBudget;
+  mStats.MemoryBytes = mMemory.GetUsed();
+  mStats.PeakMemoryBytes = std::max(mStats.PeakMemoryBytes, mStats.MemoryBytes);
+  mStats.ReservedBytes = mMemory.GetReserved();
+}
+
+const SystemPhaseTimings& World::GetPhaseTimings() const
+{
+  return mSystems->GetTimings();
+}
+
+} // namespace tk
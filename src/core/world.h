@@ -0,0 +1,115 @@
+#ifndef TK_WORLD_H
+#define TK_WORLD_H
+
+#include "core/ecs/registry.h"
+#include "core/memory_pool.h"
+#include "core/simulation_clock.h"
+#include "core/systems/system_pipeline.h"
+
+namespace tk
+{
+
+struct WorldConfig
+{
+  SimulationConfig Simulation = {};
+  // Seconds a tick may spend on fixed steps before the remaining ones are
+  // deferred to the next tick, 0 for no limit. At least one step always runs.
+  f64 TickBudget = 0.0;
+  // Backing of the registry's storages, released in one go with the world.
+  MemoryPoolConfig Memory = {};
+};
+
+// Written by the world at the end of every tick, read between ticks.
+struct WorldStats
+{
+  u64 Ticks = 0;
+  f64 LastTickTime = 0.0;
+  f64 MaxTickTime = 0.0;
+  u64 OverBudgetTicks = 0;
+  u64 DeferredSteps = 0;
+  // Memory the registry holds in the world's pool, and what the pool took
+  // from the system for it.
+  size_t MemoryBytes = 0;
+  size_t PeakMemoryBytes = 0;
+  size_t ReservedBytes = 0;
+};
+
+// Independent simulation: its own registry, core systems and clock, ticked as
+// one job on the thread pool. While a world ticks or initializes, the static
+// System accessors on that thread resolve to it instead of the engine's
+// registry. Code running in ParallelFor chunks may land on other threads and
+// has to capture what it needs instead of calling them.
+class World
+{
+  static thread_local World* mCurrent;
+
+  u32 mId = 0;
+  // Declared before the registry, which frees into it on destruction.
+  MemoryPool mMemory;
+  Registry mRegistry;
+  class CoreSystems* mSystems{};
+  SimulationClock mClock{};
+  f64 mTickBudget = 0.0;
+  WorldStats mStats = {};
+
+public:
+  // Makes a world current on the calling thread until the scope ends.
+  class Scope
+  {
+    World* mPrevious = nullptr;
+
+  public:
+    explicit Scope(World* world) : mPrevious(mCurrent)
+    {
+      mCurrent = world;
+    }
+
+    ~Scope()
+    {
+      mCurrent = mPrevious;
+    }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+  };
+
+  World(u32 id, const WorldConfig& config = {});
+  ~World();
+
+  World(const World&) = delete;
+  World& operator=(const World&) = delete;
+
+  // Runs PreUpdate, the fixed steps due, Update and PostUpdate.
+  void Tick(f32 deltaTime);
+
+  static World* GetCurrent()
+  {
+    return mCurrent;
+  }
+
+  u32 GetId() const
+  {
+    return mId;
+  }
+
+  Registry& GetRegistry()
+  {
+    return mRegistry;
+  }
+
+  const SimulationClock& GetSimulationClock() const
+  {
+    return mClock;
+  }
+
+  const WorldStats& GetStats() const
+  {
+    return mStats;
+  }
+
+  const SystemPhaseTimings& GetPhaseTimings() const;
+};
+
+} // namespace tk
+
+#endif // !TK_WORLD_H
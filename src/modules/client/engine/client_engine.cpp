@@ -1,6 +1,7 @@
 #include "client_engine.h"
 #include "core/logger.h"
 #include "core/renderer.h"
+#include "core/threads/thread_pool.h"
 #include "core/window.h"
 
 namespace tk
@@ -12,11 +13,17 @@ ClientEngine::ClientEngine()
 
 void ClientEngine::Init()
 {
-  bRunning = true;
+  Engine::Init();
+
   mWindow = new Window(400, 400, "tk");
   mWindow->Init();
   mRenderer = new Renderer();
-  mRenderer->Init(mWindow);
+  mRenderer->Init(mWindow, &GetThreadPool());
+}
+
+void ClientEngine::ConfigureThreadPool(ThreadPoolConfig& config)
+{
+  config.DedicatedThreads.push_back({EWorkerThreadType::Render, -1, EThreadPriority::High});
 }
 
 i32 ClientEngine::Run(i32 argc, char** argv)
@@ -30,23 +37,77 @@ i32 ClientEngine::Run(i32 argc, char** argv)
   try
   {
     engine.Init();
+    engine.StartRenderThread();
 
-    while (engine.bRunning)
+    while (engine.bRunning && !engine.bRenderFailed.load(std::memory_order_acquire))
     {
       engine.PollEvents();
       engine.Loop();
-      engine.Draw();
+
+      // Help the workers while the render thread catches up.
+      engine.GetThreadPool().WaitUntil([&engine]() { return engine.mSnapshots.Consumed(); });
+      if (engine.mSnapshots.Stopped())
+      {
+        break;
+      }
+      engine.Extract(engine.mSnapshots.GetWriteSlot());
+      engine.mSnapshots.Publish();
     }
+
+    engine.StopRenderThread();
   }
   catch (const std::exception& e)
   {
+    engine.StopRenderThread();
     std::cerr << e.what() << std::endl;
     return 1;
   }
 
   engine.Clean();
 
-  return 0;
+  return engine.bRenderFailed ? 1 : 0;
+}
+
+void ClientEngine::StartRenderThread()
+{
+  mRenderThread = GetThreadPool().Submit(
+      [this]() {
+        try
+        {
+          while (!mSnapshots.Stopped())
+          {
+            Draw();
+          }
+        }
+        catch (const std::exception& e)
+        {
+          Logger::Error("Render thread: {}", e.what());
+          bRenderFailed.store(true, std::memory_order_release);
+          mSnapshots.Stop();
+        }
+      },
+      EWorkerThreadType::Render);
+}
+
+void ClientEngine::StopRenderThread()
+{
+  mSnapshots.Stop();
+  if (mRenderThread.IsValid())
+  {
+    GetThreadPool().Wait(mRenderThread);
+  }
+}
+
+void ClientEngine::Extract(RenderSnapshot& snapshot)
+{
+  snapshot.Frame = ++mFrame;
+  snapshot.Alpha = GetSimulationClock().GetAlpha();
+  snapshot.Camera = RenderCamera{};
+  snapshot.Instances = mRenderer->AcquireInstanceBuffer();
+  snapshot.ShapeRanges = {};
+
+  Engine::Extract(snapshot);
+  mRenderer->ImGuiDraw(snapshot);
 }
 
 void ClientEngine::PollEvents()
@@ -60,8 +121,13 @@ void ClientEngine::PollEvents()
 
 void ClientEngine::Draw()
 {
-  mRenderer->ImGuiDraw();
-  mRenderer->DrawFrame();
+  const RenderSnapshot* snapshot = mSnapshots.AcquireLatest();
+  if (!snapshot)
+  {
+    return;
+  }
+
+  mRenderer->DrawFrame(*snapshot);
 }
 
 void ClientEngine::Clean()
@@ -71,6 +137,8 @@ void ClientEngine::Clean()
 
   mWindow->Clean();
   delete mWindow;
+
+  Engine::Clean();
 }
 
 } // namespace tk
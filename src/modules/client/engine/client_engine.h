@@ -2,6 +2,10 @@
 #define TK_CLIENT_ENGINE_H
 
 #include "core/engine.h"
+#include "core/render_snapshot.h"
+#include "core/threads/job.h"
+#include "core/threads/triple_buffer.h"
+#include <atomic>
 
 namespace tk
 {
@@ -11,15 +15,28 @@ class ClientEngine : public Engine
   class Renderer* mRenderer{};
   class Window* mWindow{};
 
+  // The game thread extracts frame N+1 into the write slot while the render
+  // thread draws frame N from its own slot.
+  TripleBuffer<RenderSnapshot> mSnapshots{};
+  JobHandle mRenderThread{};
+  std::atomic<bool> bRenderFailed = false;
+  u64 mFrame = 0;
+
 public:
   ClientEngine();
 
   static i32 Run(i32 argc, char** arcv);
 
   virtual void Init() override;
+  virtual void ConfigureThreadPool(ThreadPoolConfig& config) override;
   virtual void Draw() override;
   virtual void Clean() override;
   virtual void PollEvents() override;
+
+private:
+  void StartRenderThread();
+  void StopRenderThread();
+  void Extract(RenderSnapshot& snapshot);
 };
 
 } // namespace tk
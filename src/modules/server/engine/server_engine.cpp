@@ -0,0 +1,58 @@
+#include "server_engine.h"
+#include "core/threads/thread_pool.h"
+#include <algorithm>
+
+namespace tk::Server
+{
+
+World& Engine::CreateWorld(const WorldConfig& config)
+{
+  World* world = new World(mNextWorldId++, config);
+  mWorlds.push_back(world);
+  return *world;
+}
+
+void Engine::DestroyWorld(World& world)
+{
+  auto it = std::find(mWorlds.begin(), mWorlds.end(), &world);
+  if (it != mWorlds.end())
+  {
+    mWorlds.erase(it);
+    delete &world;
+  }
+}
+
+void Engine::Loop()
+{
+  tk::Engine::Loop();
+  TickWorlds();
+}
+
+void Engine::Clean()
+{
+  for (World* world : mWorlds)
+  {
+    delete world;
+  }
+  mWorlds.clear();
+
+  tk::Engine::Clean();
+}
+
+void Engine::TickWorlds()
+{
+  auto now = std::chrono::steady_clock::now();
+  f32 deltaTime =
+      mLastWorldTick.time_since_epoch().count() ? std::chrono::duration<f32>(now - mLastWorldTick).count() : 0.f;
+  mLastWorldTick = now;
+
+  ThreadPool& pool = GetThreadPool();
+  JobCounter counter;
+  for (World* world : mWorlds)
+  {
+    pool.Submit([world, deltaTime]() { world->Tick(deltaTime); }, counter);
+  }
+  pool.Wait(counter);
+}
+
+} // namespace tk::Server
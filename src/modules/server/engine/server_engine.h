@@ -1,13 +1,38 @@
 #ifndef TK_SERVER_ENGINE_H
 #define TK_SERVER_ENGINE_H
 
+#include "core/dynamic_array.h"
 #include "core/engine.h"
+#include "core/world.h"
+#include <chrono>
 
 namespace tk::Server
 {
 
+// Hosts any number of independent worlds, e.g. one per match, next to the
+// engine's own registry. Every frame each world ticks as its own job on the
+// thread pool. Worlds are created and destroyed between frames.
 class Engine : public tk::Engine
 {
+  DynamicArray<World*> mWorlds = {};
+  u32 mNextWorldId = 1;
+  std::chrono::steady_clock::time_point mLastWorldTick{};
+
+public:
+  World& CreateWorld(const WorldConfig& config = {});
+  void DestroyWorld(World& world);
+
+  const DynamicArray<World*>& GetWorlds() const
+  {
+    return mWorlds;
+  }
+
+protected:
+  virtual void Loop() override;
+  virtual void Clean() override;
+
+private:
+  void TickWorlds();
 };
 
 } // namespace tk::Server
@@ -0,0 +1,79 @@
+#ifndef TK_BENCH_H
+#define TK_BENCH_H
+
+#include "core/types.h"
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+namespace tk::Bench
+{
+
+// Keeps the compiler from dropping work whose result is never used.
+template <typename T> inline void DoNotOptimize(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : "r,m"(value) : "memory");
+#else
+  static volatile const void* sink;
+  sink = &value;
+#endif
+}
+
+// Spins a little, then yields, so busy-waiting threads still make progress
+// when there are more of them than cores.
+class Backoff
+{
+  u32 mSpins = 0;
+
+public:
+  void Pause()
+  {
+    if (++mSpins > 64)
+    {
+      std::this_thread::yield();
+    }
+  }
+};
+
+inline f64 NowMs()
+{
+  return std::chrono::duration<f64, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Best wall time of runs calls, in milliseconds. The best run is the one
+// least disturbed by the rest of the machine.
+template <typename Func> f64 BestOf(u32 runs, Func&& func)
+{
+  f64 best = 0.0;
+  for (u32 run = 0; run < runs; run++)
+  {
+    f64 start = NowMs();
+    func();
+    f64 elapsed = NowMs() - start;
+    best = run == 0 || elapsed < best ? elapsed : best;
+  }
+  return best;
+}
+
+// One result row: items processed in ms.
+inline void Report(const char* name, f64 ms, f64 items)
+{
+  std::printf("  %-44s %10.3f ms %10.2f M/s %8.2f ns/item\n", name, ms, items / ms / 1e3, ms * 1e6 / items);
+  std::fflush(stdout);
+}
+
+inline void Section(const char* name)
+{
+  std::printf("%s\n", name);
+  std::fflush(stdout);
+}
+
+void RunQueues();
+void RunThreadPool();
+void RunTransform();
+void RunSpawn();
+
+} // namespace tk::Bench
+
+#endif // !TK_BENCH_H
@@ -0,0 +1,196 @@
+#include "bench.h"
+#include "core/threads/mpmc_queue.h"
+#include "core/threads/spsc_queue.h"
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace tk::Bench
+{
+
+namespace
+{
+
+constexpr u64 QueueCapacity = 1024;
+constexpr u64 ThroughputItems = 1 << 23;
+constexpr u64 RoundTrips = 1 << 18;
+
+// What the lock-free queues replace, for reference.
+template <typename T> class LockedQueue
+{
+  std::mutex mMutex;
+  std::deque<T> mItems;
+  u64 mCapacity;
+
+public:
+  explicit LockedQueue(u64 capacity) : mCapacity(capacity)
+  {
+  }
+
+  bool TryPush(const T& value)
+  {
+    std::lock_guard lock(mMutex);
+    if (mItems.size() >= mCapacity)
+    {
+      return false;
+    }
+    mItems.push_back(value);
+    return true;
+  }
+
+  bool TryPop(T& outValue)
+  {
+    std::lock_guard lock(mMutex);
+    if (mItems.empty())
+    {
+      return false;
+    }
+    outValue = mItems.front();
+    mItems.pop_front();
+    return true;
+  }
+};
+
+// Producers push ThroughputItems in total while consumers drain them, all
+// threads start together. Returns the wall time in ms.
+template <typename Queue> f64 Throughput(u32 producers, u32 consumers)
+{
+  Queue queue(QueueCapacity);
+  std::atomic<bool> bStart = false;
+  std::atomic<u64> popped = 0;
+  std::vector<std::thread> threads;
+
+  u64 perProducer = ThroughputItems / producers;
+  u64 total = perProducer * producers;
+  for (u32 p = 0; p < producers; p++)
+  {
+    threads.emplace_back([&queue, &bStart, perProducer]() {
+      for (Backoff backoff; !bStart.load(std::memory_order_acquire);)
+      {
+        backoff.Pause();
+      }
+      for (u64 i = 0; i < perProducer; i++)
+      {
+        for (Backoff backoff; !queue.TryPush(i);)
+        {
+          backoff.Pause();
+        }
+      }
+    });
+  }
+  for (u32 c = 0; c < consumers; c++)
+  {
+    threads.emplace_back([&queue, &bStart, &popped, total]() {
+      for (Backoff backoff; !bStart.load(std::memory_order_acquire);)
+      {
+        backoff.Pause();
+      }
+      u64 value = 0;
+      u64 sum = 0;
+      Backoff backoff;
+      while (popped.load(std::memory_order_relaxed) < total)
+      {
+        if (queue.TryPop(value))
+        {
+          sum += value;
+          popped.fetch_add(1, std::memory_order_relaxed);
+          backoff = {};
+        }
+        else
+        {
+          backoff.Pause();
+        }
+      }
+      DoNotOptimize(sum);
+    });
+  }
+
+  f64 start = NowMs();
+  bStart.store(true, std::memory_order_release);
+  for (std::thread& thread : threads)
+  {
+    thread.join();
+  }
+  return NowMs() - start;
+}
+
+// One thread sends a value through the first queue, the other echoes it
+// through the second. Half a round trip is the handoff latency.
+template <typename Queue> f64 PingPong()
+{
+  Queue ping(QueueCapacity);
+  Queue pong(QueueCapacity);
+  std::thread echo([&ping, &pong]() {
+    u64 value = 0;
+    for (u64 i = 0; i < RoundTrips; i++)
+    {
+      for (Backoff backoff; !ping.TryPop(value);)
+      {
+        backoff.Pause();
+      }
+      for (Backoff backoff; !pong.TryPush(value);)
+      {
+        backoff.Pause();
+      }
+    }
+  });
+
+  f64 start = NowMs();
+  u64 value = 0;
+  for (u64 i = 0; i < RoundTrips; i++)
+  {
+    for (Backoff backoff; !ping.TryPush(i);)
+    {
+      backoff.Pause();
+    }
+    for (Backoff backoff; !pong.TryPop(value);)
+    {
+      backoff.Pause();
+    }
+  }
+  f64 elapsed = NowMs() - start;
+  echo.join();
+  return elapsed;
+}
+
+template <typename Queue> void ReportLatency(const char* name)
+{
+  f64 ms = PingPong<Queue>();
+  for (u32 run = 1; run < 3; run++)
+  {
+    ms = std::min(ms, PingPong<Queue>());
+  }
+  Report(name, ms, (f64)RoundTrips * 2.0);
+}
+
+} // namespace
+
+void RunQueues()
+{
+  u32 cores = std::thread::hardware_concurrency();
+  char name[64];
+
+  Section("Queue throughput, 1 producer / 1 consumer");
+  Report("SPSCQueue", Throughput<SPSCQueue<u64>>(1, 1), (f64)ThroughputItems);
+  Report("MPMCQueue", Throughput<MPMCQueue<u64>>(1, 1), (f64)ThroughputItems);
+  Report("std::mutex + std::deque", Throughput<LockedQueue<u64>>(1, 1), (f64)ThroughputItems);
+
+  Section("Queue throughput under contention, N producers / N consumers");
+  for (u32 threads = 2; threads <= std::max(cores / 2, 2u) && threads <= 16; threads *= 2)
+  {
+    std::snprintf(name, sizeof(name), "MPMCQueue %u/%u", threads, threads);
+    Report(name, Throughput<MPMCQueue<u64>>(threads, threads), (f64)ThroughputItems);
+    std::snprintf(name, sizeof(name), "std::mutex + std::deque %u/%u", threads, threads);
+    Report(name, Throughput<LockedQueue<u64>>(threads, threads), (f64)ThroughputItems);
+  }
+
+  Section("Queue handoff latency, ping-pong between two threads (ns/item = one way)");
+  ReportLatency<SPSCQueue<u64>>("SPSCQueue");
+  ReportLatency<MPMCQueue<u64>>("MPMCQueue");
+  ReportLatency<LockedQueue<u64>>("std::mutex + std::deque");
+}
+
+} // namespace tk::Bench
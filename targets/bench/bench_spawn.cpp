@@ -0,0 +1,115 @@
+#include "bench.h"
+#include "core/components/c_transform2d.h"
+#include "core/components/c_velocity.h"
+#include "core/engine.h"
+#include "core/systems/system.h"
+#include <algorithm>
+
+namespace tk::Bench
+{
+
+namespace
+{
+
+constexpr u32 NumEntities = 1000000;
+constexpr u32 Runs = 3;
+
+// Thread pool and core systems without a window, so spawning pays for the
+// same registry hooks as in the game.
+class BenchEngine : public Engine
+{
+public:
+  BenchEngine()
+  {
+    Init();
+  }
+
+  ~BenchEngine()
+  {
+    Clean();
+  }
+};
+
+// Exposes the spawn helpers game systems use.
+class Spawner : public System
+{
+public:
+  using System::AddComponent;
+  using System::AddComponents;
+  using System::CreateEntities;
+  using System::CreateEntity;
+  using System::DestroyEntities;
+  using System::GetRegistry;
+};
+
+struct Timings
+{
+  f64 SpawnMs = 0.0;
+  f64 DestroyMs = 0.0;
+};
+
+// Best spawn and destroy times over Runs, each run starts from an empty
+// registry.
+template <typename Spawn, typename Destroy> Timings Measure(Spawn&& spawn, Destroy&& destroy)
+{
+  Timings best;
+  for (u32 run = 0; run < Runs; run++)
+  {
+    f64 start = NowMs();
+    spawn();
+    f64 spawned = NowMs();
+    destroy();
+    f64 destroyed = NowMs();
+    best.SpawnMs = run == 0 ? spawned - start : std::min(best.SpawnMs, spawned - start);
+    best.DestroyMs = run == 0 ? destroyed - spawned : std::min(best.DestroyMs, destroyed - spawned);
+  }
+  return best;
+}
+
+} // namespace
+
+void RunSpawn()
+{
+  BenchEngine engine;
+  DynamicArray<entt::entity> entities(NumEntities);
+  DynamicArray<CTransform> transforms(NumEntities);
+  for (u32 i = 0; i < NumEntities; i++)
+  {
+    transforms[i] = CTransform{v2((f32)(i % 1024), (f32)(i / 1024)), 0.f, 1.f};
+  }
+  const CVelocity velocity{v2(1.f, 0.f), 0.5f};
+
+  Timings single = Measure(
+      [&entities, &transforms, &velocity]() {
+        for (u32 i = 0; i < NumEntities; i++)
+        {
+          entities[i] = Spawner::CreateEntity();
+          Spawner::AddComponent(entities[i], transforms[i]);
+          Spawner::AddComponent(entities[i], velocity);
+        }
+      },
+      [&entities]() {
+        Registry& registry = Spawner::GetRegistry();
+        for (entt::entity entity : entities)
+        {
+          registry.destroy(entity);
+        }
+      });
+
+  Timings bulk = Measure(
+      [&entities, &transforms, &velocity]() {
+        Spawner::CreateEntities(entities.data(), NumEntities);
+        Spawner::AddComponents(entities.data(), NumEntities, transforms.data());
+        Spawner::AddComponents(entities.data(), NumEntities, velocity);
+      },
+      [&entities]() { Spawner::DestroyEntities(entities.data(), NumEntities); });
+
+  Section("Spawn 1M entities with CTransform and CVelocity, core systems connected");
+  Report("per entity, CreateEntity + AddComponent", single.SpawnMs, NumEntities);
+  Report("bulk, CreateEntities + AddComponents", bulk.SpawnMs, NumEntities);
+  Section("Destroy 1M entities");
+  Report("per entity, Registry::destroy", single.DestroyMs, NumEntities);
+  Report("bulk, DestroyEntities", bulk.DestroyMs, NumEntities);
+}
+
+} // namespace tk::Bench
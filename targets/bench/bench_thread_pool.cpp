@@ -0,0 +1,89 @@
+#include "bench.h"
+#include "core/threads/thread_pool.h"
+#include <thread>
+
+namespace tk::Bench
+{
+
+namespace
+{
+
+// Both job sizes do the same total work.
+constexpr u32 TotalUnits = 1 << 23;
+constexpr u32 FineUnits = 128;
+constexpr u32 CoarseUnits = 1 << 15;
+constexpr u32 Parents = 64;
+
+void Work(u32 units)
+{
+  u64 x = units;
+  for (u32 i = 0; i < units; i++)
+  {
+    x = x * 6364136223846793005ull + 1442695040888963407ull;
+  }
+  DoNotOptimize(x);
+}
+
+// Parent jobs submitted from outside the pool spawn the actual jobs from
+// inside it, so they land in the workers' own deques and get stolen from
+// there. The calling thread helps while it waits.
+f64 Spawn(ThreadPool& pool, u32 unitsPerJob)
+{
+  u32 jobs = TotalUnits / unitsPerJob;
+  u32 children = jobs / Parents;
+  return BestOf(5, [&pool, unitsPerJob, children]() {
+    JobCounter counter;
+    for (u32 parent = 0; parent < Parents; parent++)
+    {
+      pool.Submit(
+          [&pool, &counter, unitsPerJob, children]() {
+            for (u32 child = 0; child < children; child++)
+            {
+              pool.Submit([unitsPerJob]() { Work(unitsPerJob); }, counter);
+            }
+          },
+          counter);
+    }
+    pool.Wait(counter);
+  });
+}
+
+} // namespace
+
+void RunThreadPool()
+{
+  u32 cores = std::thread::hardware_concurrency();
+  DynamicArray<u32> workerCounts;
+  for (u32 workers = 1; workers < cores; workers *= 2)
+  {
+    workerCounts.push_back(workers);
+  }
+  workerCounts.push_back(cores > 0 ? cores : 1);
+
+  struct Case
+  {
+    const char* Name;
+    u32 Units;
+    f64 BaseMs;
+  };
+  Case cases[] = {{"fine", FineUnits, 0.0}, {"coarse", CoarseUnits, 0.0}};
+
+  Section("ThreadPool scaling, same total work in fine and coarse jobs (ns/item = per job)");
+  char name[64];
+  for (u32 workers : workerCounts)
+  {
+    ThreadPool pool(workers);
+    pool.Run();
+    for (Case& c : cases)
+    {
+      f64 ms = Spawn(pool, c.Units);
+      c.BaseMs = c.BaseMs > 0.0 ? c.BaseMs : ms;
+      std::snprintf(name, sizeof(name), "%s %u x %u, %u workers (%.2fx)", c.Name, TotalUnits / c.Units, c.Units,
+                    workers, c.BaseMs / ms);
+      Report(name, ms, (f64)(TotalUnits / c.Units));
+    }
+    pool.Shutdown();
+  }
+}
+
+} // namespace tk::Bench
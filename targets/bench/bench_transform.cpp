@@ -0,0 +1,83 @@
+#include "bench.h"
+#include "core/ecs/transform_soa.h"
+
+namespace tk::Bench
+{
+
+namespace
+{
+
+constexpr u32 NumEntities = 1000000;
+constexpr f32 StepTime = 1.f / 60.f;
+
+const char* SimdLevelName(ESimdLevel level)
+{
+  switch (level)
+  {
+  case ESimdLevel::AVX2:
+    return "AVX2";
+  case ESimdLevel::SSE2:
+    return "SSE2";
+  default:
+    return "scalar";
+  }
+}
+
+} // namespace
+
+void RunTransform()
+{
+  Registry registry;
+  TransformSoA soa;
+  DynamicArray<entt::entity> entities(NumEntities);
+  registry.create(entities.begin(), entities.end());
+  for (u32 i = 0; i < NumEntities; i++)
+  {
+    CTransform transform{v2((f32)(i % 1024), (f32)(i / 1024)), 0.001f * (f32)i, 1.f};
+    CVelocity velocity{v2(1.f, 0.5f * (f32)(i % 7)), 0.25f};
+    registry.emplace<CTransform>(entities[i], transform);
+    registry.emplace<CVelocity>(entities[i], velocity);
+    soa.Add(entities[i], transform, velocity);
+  }
+  DynamicArray<Affine2D> matrices(NumEntities);
+  char name[64];
+
+  Section("Integrate velocity, 1M entities, one thread");
+  auto view = registry.view<CTransform, CVelocity>();
+  Report("entt AoS view, scalar", BestOf(10, [&view]() {
+           view.each([](CTransform& transform, const CVelocity& velocity) {
+             transform.Position += velocity.Linear * StepTime;
+             transform.Rotation += velocity.Angular * StepTime;
+           });
+         }),
+         NumEntities);
+  std::snprintf(name, sizeof(name), "TransformSoA, %s", SimdLevelName(TransformKernels::GetSimdLevel()));
+  Report(name, BestOf(10, [&soa]() { soa.Integrate(0, soa.Size(), StepTime); }), NumEntities);
+  // What SIntegrate pays every step, CTransform stays the public copy.
+  std::snprintf(name, sizeof(name), "TransformSoA, %s + write back", SimdLevelName(TransformKernels::GetSimdLevel()));
+  Report(name, BestOf(10, [&soa, &registry]() {
+           soa.Integrate(0, soa.Size(), StepTime);
+           soa.WriteBack(registry, 0, soa.Size());
+         }),
+         NumEntities);
+
+  Section("Build model matrices, 1M entities, one thread");
+  Report("entt AoS view, scalar", BestOf(10, [&registry, &matrices]() {
+           Affine2D* out = matrices.data();
+           registry.view<CTransform>().each([&out](const CTransform& transform) {
+             f32 s, c;
+             TransformKernels::SinCos(transform.Rotation, s, c);
+             out->Column0 = v2(c, s) * transform.Scale;
+             out->Column1 = v2(-s, c) * transform.Scale;
+             out->Translation = transform.Position;
+             out++;
+           });
+         }),
+         NumEntities);
+  std::snprintf(name, sizeof(name), "TransformSoA, %s", SimdLevelName(TransformKernels::GetSimdLevel()));
+  Report(name, BestOf(10, [&soa, &matrices]() { soa.BuildModelMatrices(0, soa.Size(), matrices.data()); }),
+         NumEntities);
+  DoNotOptimize(matrices.back());
+}
+
+} // namespace tk::Bench
@@ -0,0 +1,37 @@
+#include "bench.h"
+#include <cstring>
+
+namespace
+{
+
+struct BenchEntry
+{
+  const char* Name;
+  void (*Run)();
+};
+
+constexpr BenchEntry Benchmarks[] = {
+    {"queues", tk::Bench::RunQueues},
+    {"threadpool", tk::Bench::RunThreadPool},
+    {"transform", tk::Bench::RunTransform},
+    {"spawn", tk::Bench::RunSpawn},
+};
+
+} // namespace
+
+// bench [name...] runs the named benchmarks, or all of them without names.
+int main(int argc, char* argv[])
+{
+  for (const BenchEntry& bench : Benchmarks)
+  {
+    bool bSelected = argc < 2;
+    for (int i = 1; i < argc; i++)
+    {
+      bSelected |= std::strcmp(argv[i], bench.Name) == 0;
+    }
+    if (bSelected)
+    {
+      bench.Run();
+    }
+  }
+}
@@ -9,9 +9,27 @@ layout(binding = 0) uniform UniformBufferObject {
 layout(location = 0) in vec2 inPosition;
 layout(location = 1) in vec3 inColor;
 
+layout(location = 2) in vec2 inInstancePosition;
+layout(location = 3) in float inInstanceRotation;
+layout(location = 4) in float inInstanceScale;
+layout(location = 5) in vec2 inInstancePrevPosition;
+layout(location = 6) in float inInstancePrevRotation;
+layout(location = 7) in float inInstancePrevScale;
+
+layout(push_constant) uniform PushConstants {
+	float alpha;
+} pc;
+
 layout(location = 0) out vec3 fragColor;
 
 void main() { 
-    gl_Position = ubo.proj * ubo.view * ubo.model * vec4(inPosition, 0.0, 1.0);
+    float rotation = mix(inInstancePrevRotation, inInstanceRotation, pc.alpha);
+    float scale = mix(inInstancePrevScale, inInstanceScale, pc.alpha);
+    vec2 translation = mix(inInstancePrevPosition, inInstancePosition, pc.alpha);
+
+    float s = sin(rotation);
+    float c = cos(rotation);
+    vec2 position = mat2(c, s, -s, c) * inPosition * scale + translation;
+    gl_Position = ubo.proj * ubo.view * ubo.model * vec4(position, 0.0, 1.0);
     fragColor = inColor;
 }